@@ -23,7 +23,7 @@ void ai::hv_trigger::ctor(entt::entity s, kontext_t& kontext) {
 
 void ai::hv_trigger::tick(entt::entity s, routine_tuple_t& rtp) {
 	auto& trigger = rtp.kontext.get<actor_trigger_t>(s);
-	if (trigger.bitmask[actor_trigger_t::InteractionEvent]) {
+	if (trigger.test(actor_trigger_t::InteractionEvent)) {
 		auto& this_location = rtp.kontext.get<location_t>(s);
 		auto& that_location = rtp.kontext.get<location_t>(rtp.naomi.get_actor());
 		if (this_location.overlap(that_location)) {
@@ -49,8 +49,8 @@ void ai::spikes::ctor(entt::entity s, kontext_t& kontext) {
 	auto& location = kontext.get<location_t>(s);
 	location.bounding = { 4.0f, 4.0f, 8.0f, 8.0f };
 
-	auto& sprite = kontext.assign_if<sprite_t>(s, res::anim::Death);
-	sprite.pivot = { 8.0f, 8.0f };
+	kontext.assign_if<sprite_t>(s, res::anim::Death);
+	kontext.assign_if<sprite_rotation_t>(s, glm::vec2(8.0f, 8.0f));
 }
 
 void ai::death_spikes::ctor(entt::entity s, kontext_t& kontext) {
@@ -102,3 +102,7 @@ LEVIATHAN_CTOR_TABLE_CREATE(common) {
 	LEVIATHAN_TABLE_PUSH(ai::computer::type, 		ai::computer::ctor);
 	LEVIATHAN_TABLE_PUSH(ai::fire::type, 			ai::fire::ctor);
 }
+
+LEVIATHAN_TICK_TABLE_CREATE(common) {
+	LEVIATHAN_TABLE_PUSH(ai::hv_trigger::type, 		ai::hv_trigger::tick);
+}
@@ -88,3 +88,7 @@ LEVIATHAN_CTOR_TABLE_CREATE(friends) {
 	LEVIATHAN_TABLE_PUSH(ai::fox::type, 	ai::fox::ctor);
 	LEVIATHAN_TABLE_PUSH(ai::gyo::type, 	ai::gyo::ctor);
 }
+
+LEVIATHAN_TICK_TABLE_CREATE(friends) {
+	LEVIATHAN_TABLE_PUSH(ai::friends::name, ai::friends::tick);
+}
@@ -4,6 +4,8 @@
 
 namespace ai {
 	namespace friends {
+		// Shared by every friend, so it gets a name of its own in the tick table
+		constexpr entt::hashed_string name = "friends";
 		void tick(entt::entity s, routine_tuple_t& rtp);
 	}
 	namespace kyoko {
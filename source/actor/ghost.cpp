@@ -16,7 +16,7 @@ void ai::ghost::ctor(entt::entity s, kontext_t& kontext) {
 
 	auto& sprite = kontext.assign_if<sprite_t>(s, res::anim::Ghost);
 	sprite.layer = layer_value::Automatic;
-	sprite.pivot = { 8.0f, 16.0f };
+	kontext.assign_if<sprite_rotation_t>(s, glm::vec2(8.0f, 16.0f));
 
 	if (location.direction & direction_t::Left) {
 		sprite.mirroring = mirroring_t::Horizontal;
@@ -48,7 +48,7 @@ void ai::ghost::tick(entt::entity s, routine_tuple_t& rtp) {
 		auto& location = rtp.kontext.get<location_t>(s);
 		rtp.kontext.shrapnel(location.center(), 2);
 
-		sprite.shake = 0.3f;
+		rtp.kontext.get<sprite_rotation_t>(s).shake = 0.3f;
 		sprite.new_state(1);
 	}
 }
@@ -58,3 +58,7 @@ void ai::ghost::tick(entt::entity s, routine_tuple_t& rtp) {
 LEVIATHAN_CTOR_TABLE_CREATE(ghost) {
 	LEVIATHAN_TABLE_PUSH(ai::ghost::type, ai::ghost::ctor);
 }
+
+LEVIATHAN_TICK_TABLE_CREATE(ghost) {
+	LEVIATHAN_TABLE_PUSH(ai::ghost::type, ai::ghost::tick);
+}
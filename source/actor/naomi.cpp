@@ -23,6 +23,7 @@
 #include "../system/audio.hpp"
 #include "../system/kernel.hpp"
 #include "../system/receiver.hpp"
+#include "../system/snapshot.hpp"
 #include "../utility/constants.hpp"
 #include "../utility/logger.hpp"
 
@@ -44,13 +45,14 @@ bool naomi_state_t::init(kontext_t& kontext) {
 	}
 	auto& location = backend->emplace<location_t>(actor);
 
-	auto& kinematics = backend->emplace<kinematics_t>(actor);
-	kinematics.discrete = {
+	backend->emplace<kinematics_t>(actor);
+	backend->emplace<kinematics_discrete_t>(actor, rect_t {
 		4.0f,
 		16.0f / 3.0f,
 		8.0f,
 		16.0f / 3.0f
-	};
+	});
+	backend->emplace<kinematics_tether_t>(actor);
 
 	auto& sprite = backend->emplace<sprite_t>(actor, res::anim::Naomi);
 	backend->emplace<health_t>(actor);
@@ -85,6 +87,7 @@ void naomi_state_t::reset(kontext_t& kontext) {
 	location.direction = direction_t::Right;
 	kinematics.reset();
 	kinematics.flags[phy_t::Bottom] = true;
+	kontext.get<kinematics_tether_t>(actor).reset();
 	sprite.reset();
 	sprite.layer = 0.35f;
 	health.reset(2, 2, 0, 0);
@@ -125,6 +128,7 @@ void naomi_state_t::reset(kontext_t& kontext, const glm::vec2& position, directi
 
 	kinematics.reset();
 	kinematics.flags[phy_t::Bottom] = true;
+	kontext.get<kinematics_tether_t>(actor).reset();
 	sprite.reset();
 	sprite.layer = 0.35f;
 	health.reset(current_barrier, maximum_barrier, leviathan, 0);
@@ -164,7 +168,7 @@ void naomi_state_t::setup(audio_t& audio, const kernel_t& kernel, camera_t& came
 	kinematics.flags[phy_t::Noclip] = false;
 	kinematics.flags[phy_t::Outbounds] = false;
 	kinematics.flags[phy_t::Bottom] = true;
-	kinematics.tether = 0.0f;
+	kontext.get<kinematics_tether_t>(actor).length = 0.0f;
 	// Reset Certain Flags
 	flags[naomi_flags_t::Reticule] = false;
 	flags[naomi_flags_t::Slinging] = false;
@@ -203,7 +207,7 @@ void naomi_state_t::handle(const input_t& input, audio_t& audio, kernel_t& kerne
 	auto& health = kontext.get<health_t>(actor);
 	auto& listener = kontext.get<liquid_listener_t>(actor);
 
-	this->do_begin(audio, kinematics);
+	this->do_begin(audio, kinematics, kontext.get<kinematics_tether_t>(actor));
 	if (flags[naomi_flags_t::Killed]) {
 		this->do_killed(location, kinematics);
 	} else if (!kernel.has(kernel_t::Lock)) {
@@ -360,7 +364,11 @@ void naomi_state_t::solids(entt::entity other, kontext_t& kontext, const tilemap
 		if (n_bottom >= o_top and n_bottom <= o_center_y) {
 			naomi_location.position.y = other_hitbox.side(side_t::Top) - naomi_location.bounding.side(side_t::Bottom);
 			naomi_kinematics.velocity.y = 0.0f;
-			kinematics_t::handle(naomi_location, naomi_kinematics, tilemap, other_kinematics.velocity);
+			kinematics_t::handle(
+				naomi_location, naomi_kinematics, tilemap, other_kinematics.velocity,
+				&kontext.get<kinematics_discrete_t>(actor).bounding,
+				&kontext.get<kinematics_tether_t>(actor)
+			);
 			naomi_kinematics.flags[phy_t::Bottom] = true;
 
 			if (other_kinematics.velocity.x != 0.0f and riding.x == 0.0f) {
@@ -415,6 +423,52 @@ void naomi_state_t::set_phys_const(bool submerged) {
 	}
 }
 
+void naomi_state_t::write(snapshot_writer_t& writer) const {
+	writer.value<uint64_t>(flags.to_ullong());
+	writer.value<uint64_t>(equips.to_ullong());
+	writer.array(chroniker);
+	writer.value(riding);
+	writer.value(view_point);
+	writer.value(reticule);
+	writer.value(last_direction);
+	writer.value(max_hspeed);
+	writer.value(max_hsling);
+	writer.value(max_vspeed);
+	writer.value(move_accel);
+	writer.value(move_decel);
+	writer.value(jump_power);
+	writer.value(jump_added);
+	writer.value(grav_speed);
+	writer.value(dash_speed);
+}
+
+bool naomi_state_t::read(snapshot_reader_t& reader) {
+	uint64_t literal_flags = 0;
+	uint64_t literal_equips = 0;
+	reader.value(literal_flags);
+	reader.value(literal_equips);
+	reader.array(chroniker);
+	reader.value(riding);
+	reader.value(view_point);
+	reader.value(reticule);
+	reader.value(last_direction);
+	reader.value(max_hspeed);
+	reader.value(max_hsling);
+	reader.value(max_vspeed);
+	reader.value(move_accel);
+	reader.value(move_decel);
+	reader.value(jump_power);
+	reader.value(jump_added);
+	reader.value(grav_speed);
+	reader.value(dash_speed);
+	if (!reader.valid()) {
+		return false;
+	}
+	flags = std::bitset<naomi_flags_t::Total>(literal_flags);
+	equips = std::bitset<naomi_equips_t::Total>(literal_equips);
+	return true;
+}
+
 void naomi_state_t::set_visible(bool visible) {
 	entt::entity actor = this->get_actor();
 
@@ -561,10 +615,10 @@ sint_t naomi_state_t::get_box_data(const headsup_gui_t& headsup_gui, const std::
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void naomi_state_t::do_begin(audio_t& audio, kinematics_t& kinematics) {
+void naomi_state_t::do_begin(audio_t& audio, kinematics_t& kinematics, const kinematics_tether_t& tether) {
 	flags[naomi_flags_t::Interacting] = false;
 	flags[naomi_flags_t::HealthIncrement] = false;
-	flags[naomi_flags_t::TetheredTile] = kinematics.tether > 0.0f;
+	flags[naomi_flags_t::TetheredTile] = tether.length > 0.0f;
 	if (kinematics.flags[phy_t::Bottom]) {
 		if (flags[naomi_flags_t::Airbourne]) {
 			flags[naomi_flags_t::Airbourne] = false;
@@ -878,10 +932,14 @@ void naomi_state_t::do_interact(const input_t& input, receiver_t& receiver, kont
 				kinematics.velocity.x = 0.0f;
 				flags[naomi_flags_t::Interacting] = true;
 				rect_t hitbox = location.hitbox();
-				kontext.slice<actor_trigger_t, location_t>().each([&hitbox, &receiver](entt::entity, const actor_trigger_t& trigger, const location_t& location) {
-					if (trigger.bitmask[actor_trigger_t::InteractionEvent]) {
-						if (location.overlap(hitbox)) {
-							receiver.run_event(trigger.identity);
+				kontext.get_broadphase().query(hitbox, [&kontext, &hitbox, &receiver](entt::entity actor) {
+					if (kontext.alive(actor) and kontext.has<actor_trigger_t, location_t>(actor)) {
+						auto& trigger = kontext.get<actor_trigger_t>(actor);
+						auto& location = kontext.get<location_t>(actor);
+						if (trigger.test(actor_trigger_t::InteractionEvent)) {
+							if (location.overlap(hitbox)) {
+								receiver.run_event(trigger.identity);
+							}
 						}
 					}
 				});
@@ -15,9 +15,12 @@ struct headsup_gui_t;
 struct camera_t;
 struct kontext_t;
 struct tilemap_t;
+struct snapshot_writer_t;
+struct snapshot_reader_t;
 
 struct location_t;
 struct kinematics_t;
+struct kinematics_tether_t;
 struct sprite_t;
 struct blinker_t;
 struct health_t;
@@ -165,6 +168,8 @@ public:
 	void handle(const input_t& input, audio_t& audio, kernel_t& kernel, receiver_t& receiver, headsup_gui_t& headsup_gui, kontext_t& kontext, const tilemap_t& tilemap);
 	void damage(entt::entity other, audio_t& audio, kontext_t& kontext);
 	void solids(entt::entity other, kontext_t& kontext, const tilemap_t& tilemap);
+	void write(snapshot_writer_t& writer) const;
+	bool read(snapshot_reader_t& reader);
 	void set_phys_const(bool submerged);
 	void set_visible(bool visible);
 	void set_equips(naomi_equips_t flag, bool value);
@@ -182,7 +187,7 @@ public:
 	naomi_death_t get_death_type(const kinematics_t& kinematics, const health_t& health) const;
 	static sint_t get_box_data(const headsup_gui_t& headsup_gui, const std::bitset<naomi_flags_t::Total>& flags, const headsup_params_t& params);
 private:
-	void do_begin(audio_t& audio, kinematics_t& kinematics);
+	void do_begin(audio_t& audio, kinematics_t& kinematics, const kinematics_tether_t& tether);
 	void do_killed(location_t& location, kinematics_t& kinematics);
 	void do_recovery(kinematics_t& kinematics);
 	void do_meter_leviathan(health_t& health);
@@ -208,3 +208,9 @@ LEVIATHAN_CTOR_TABLE_CREATE(shoshi) {
 	LEVIATHAN_TABLE_PUSH(ai::shoshi_carry::type, 	ai::shoshi_carry::ctor);
 	LEVIATHAN_TABLE_PUSH(ai::shoshi_follow::type, 	ai::shoshi_follow::ctor);
 }
+
+LEVIATHAN_TICK_TABLE_CREATE(shoshi) {
+	LEVIATHAN_TABLE_PUSH(ai::shoshi::type, 			ai::shoshi::tick);
+	LEVIATHAN_TABLE_PUSH(ai::shoshi_carry::type, 	ai::shoshi_carry::tick);
+	LEVIATHAN_TABLE_PUSH(ai::shoshi_follow::type, 	ai::shoshi_follow::tick);
+}
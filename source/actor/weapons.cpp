@@ -19,28 +19,62 @@
 #include "../system/audio.hpp"
 #include "../utility/rng.hpp"
 
+namespace {
+	// Ticks and batches both run these two phases per actor. The first phase only touches
+	// the actor's own timer and motion, so running it across a whole group before the second
+	// matches ticking each actor in turn. Actors disposed by the second phase are destroyed at
+	// the next flush, before they move or draw again.
+	void frontier_spin(entt::entity s, kontext_t& kontext) {
+		auto& timer = kontext.get<actor_timer_t>(s);
+		auto& rotation = kontext.get<sprite_rotation_t>(s);
+		timer[0]--;
+		rotation.angle = glm::mod(rotation.angle + 0.035f, glm::two_pi<real_t>());
+	}
+
+	void frontier_strike(entt::entity s, kontext_t& kontext) {
+		auto& timer = kontext.get<actor_timer_t>(s);
+		auto& listener = kontext.get<liquid_listener_t>(s);
+		if (listener.liquid != entt::null and kontext.valid(listener.liquid)) {
+			auto& location = kontext.get<location_t>(s);
+			location.position.y = kontext.get<liquid_body_t>(listener.liquid).hitbox.y;
+		}
+		if (timer[0] < 0 or ai::weapons::damage_check(s, kontext)) {
+			kontext.dispose(s);
+		}
+	}
+
+	void toxitier_drift(entt::entity s, kontext_t& kontext) {
+		auto& kinematics = kontext.get<kinematics_t>(s);
+		auto& sprite = kontext.get<sprite_t>(s);
+		auto& timer = kontext.get<actor_timer_t>(s);
+		timer[0]--;
+		kinematics.accel_y(-0.3f, 0.6f);
+		sprite.alpha = glm::clamp(sprite.alpha - 0.016f, 0.0f, 1.0f);
+	}
+
+	void toxitier_strike(entt::entity s, kontext_t& kontext) {
+		auto& listener = kontext.get<liquid_listener_t>(s);
+		auto& timer = kontext.get<actor_timer_t>(s);
+		if (listener.liquid == entt::null or
+			!kontext.valid(listener.liquid) or
+			timer[0] < 0 or
+			ai::weapons::damage_check(s, kontext)) {
+			kontext.dispose(s);
+		}
+	}
+}
+
 // Functions
 
 entt::entity ai::weapons::find_closest(entt::entity s, kontext_t& kontext) {
 	const glm::vec2 center = kontext.get<location_t>(s).center();
 
-	std::vector<std::pair<entt::entity, real_t> > list;
-
-	kontext.slice<actor_header_t, location_t, health_t>().each([&list, &center](entt::entity actor, const actor_header_t&, const location_t& location, const health_t& health) {
-		if (health.flags[health_t::Leviathan]) {
-			auto element = std::make_pair(
-				actor, glm::distance(center, location.center())
-			);
-			list.push_back(element);
+	return kontext.get_broadphase().nearest(center, [&kontext](entt::entity actor) -> bool {
+		if (kontext.alive(actor) and kontext.has<actor_header_t, health_t>(actor)) {
+			return kontext.get<health_t>(actor).flags[health_t::Leviathan];
 		}
+		return false;
 	});
-	if (!list.empty()) {
-		std::sort(list.begin(), list.end(), [](const auto& a, const auto& b) {
-			return std::get<real_t>(a) < std::get<real_t>(b);
-		});
-		return std::get<entt::entity>(list.front());
-	}
-	return entt::null;
 }
 
 entt::entity ai::weapons::find_hooked(entt::entity s, kontext_t& kontext) {
@@ -48,8 +82,10 @@ entt::entity ai::weapons::find_hooked(entt::entity s, kontext_t& kontext) {
 
 	entt::entity result = entt::null;
 
-	kontext.slice<actor_header_t, location_t, health_t>().each([&result, &zone](entt::entity actor, const actor_header_t&, const location_t& location, health_t& health) {
-		if (result != entt::null) {
+	kontext.get_broadphase().query(zone, [&kontext, &result, &zone](entt::entity actor) {
+		if (result != entt::null and kontext.alive(actor) and kontext.has<actor_header_t, health_t>(actor)) {
+			auto& location = kontext.get<location_t>(actor);
+			auto& health = kontext.get<health_t>(actor);
 			if ((health.flags[health_t::Hookable]) and location.overlap(zone)) {
 				health.flags[health_t::Grappled] = true;
 				result = actor;
@@ -60,17 +96,24 @@ entt::entity ai::weapons::find_hooked(entt::entity s, kontext_t& kontext) {
 }
 
 bool ai::weapons::damage_check(entt::entity s, kontext_t& kontext) {
+	if (!kontext.alive(s)) {
+		return false;
+	}
 	const rect_t zone = kontext.get<location_t>(s).hitbox();
 	auto& attacker = kontext.get<health_t>(s);
 
 	entt::entity result = entt::null;
 
-	kontext.slice<actor_header_t, location_t, health_t>().each([&result, &attacker, &zone](entt::entity actor, const actor_header_t&, const location_t& location, health_t& health) {
-		if (health.flags[health_t::Leviathan] and !health.flags[health_t::Invincible]) {
-			if (location.overlap(zone)) {
-				health.flags[health_t::Hurt] = true;
-				attacker.attack(health);
-				result = actor;
+	kontext.get_broadphase().query(zone, [&kontext, &result, &attacker, &zone](entt::entity actor) {
+		if (kontext.alive(actor) and kontext.has<actor_header_t, health_t>(actor)) {
+			auto& location = kontext.get<location_t>(actor);
+			auto& health = kontext.get<health_t>(actor);
+			if (health.flags[health_t::Leviathan] and !health.flags[health_t::Invincible]) {
+				if (location.overlap(zone)) {
+					health.flags[health_t::Hurt] = true;
+					attacker.attack(health);
+					result = actor;
+				}
 			}
 		}
 	});
@@ -78,17 +121,24 @@ bool ai::weapons::damage_check(entt::entity s, kontext_t& kontext) {
 }
 
 bool ai::weapons::damage_range(entt::entity s, kontext_t& kontext, const glm::vec2& center, const glm::vec2& dimensions) {
+	if (!kontext.alive(s)) {
+		return false;
+	}
 	const rect_t zone { center - dimensions / 2.0f, dimensions };
 	auto& attacker = kontext.get<health_t>(s);
 
 	entt::entity result = entt::null;
 
-	kontext.slice<actor_header_t, location_t, health_t>().each([&result, &zone, &attacker](entt::entity actor, const actor_header_t&, const location_t& location, health_t& health) {
-		if (health.flags[health_t::Leviathan] and !health.flags[health_t::Invincible]) {
-			if (location.overlap(zone)) {
-				health.flags[health_t::Hurt] = true;
-				attacker.attack(health);
-				result = actor;
+	kontext.get_broadphase().query(zone, [&kontext, &result, &zone, &attacker](entt::entity actor) {
+		if (kontext.alive(actor) and kontext.has<actor_header_t, health_t>(actor)) {
+			auto& location = kontext.get<location_t>(actor);
+			auto& health = kontext.get<health_t>(actor);
+			if (health.flags[health_t::Leviathan] and !health.flags[health_t::Invincible]) {
+				if (location.overlap(zone)) {
+					health.flags[health_t::Hurt] = true;
+					attacker.attack(health);
+					result = actor;
+				}
 			}
 		}
 	});
@@ -96,15 +146,23 @@ bool ai::weapons::damage_range(entt::entity s, kontext_t& kontext, const glm::ve
 }
 
 bool ai::weapons::reverse_range(entt::entity s, kontext_t& kontext) {
+	if (!kontext.alive(s)) {
+		return false;
+	}
 	const rect_t zone = kontext.get<location_t>(s).hitbox();
 
 	entt::entity result = entt::null;
 
-	kontext.slice<actor_header_t, location_t, kinematics_t, health_t>().each([&result, &zone](entt::entity actor, const actor_header_t&, const location_t& location, kinematics_t& kinematics, health_t& health) {
-		if (health.flags[health_t::Deflectable] and location.overlap(zone)) {
-			health.flags[health_t::Leviathan] = false;
-			kinematics.velocity = -kinematics.velocity;
-			result = actor;
+	kontext.get_broadphase().query(zone, [&kontext, &result, &zone](entt::entity actor) {
+		if (kontext.alive(actor) and kontext.has<actor_header_t, kinematics_t, health_t>(actor)) {
+			auto& location = kontext.get<location_t>(actor);
+			auto& kinematics = kontext.get<kinematics_t>(actor);
+			auto& health = kontext.get<health_t>(actor);
+			if (health.flags[health_t::Deflectable] and location.overlap(zone)) {
+				health.flags[health_t::Leviathan] = false;
+				kinematics.velocity = -kinematics.velocity;
+				result = actor;
+			}
 		}
 	});
 	return result != entt::null;
@@ -113,12 +171,12 @@ bool ai::weapons::reverse_range(entt::entity s, kontext_t& kontext) {
 void ai::frontier::ctor(entt::entity s, kontext_t& kontext) {
 	auto& location = kontext.get<location_t>(s);
 	location.position -= 8.0f;
-	location.position.x += rng::next(-2.0f, 2.0f);
-	location.position.y += rng::next(-2.0f, 2.0f);
+	location.position.x += rng::next(rng_stream_t::Combat, -2.0f, 2.0f);
+	location.position.y += rng::next(rng_stream_t::Combat, -2.0f, 2.0f);
 	location.bounding = { 6.0f, 6.0f, 4.0f, 4.0f };
 
 	auto& kinematics = kontext.assign_if<kinematics_t>(s);
-	real_t variation = rng::next(-0.261799f, 0.261799f);
+	real_t variation = rng::next(rng_stream_t::Combat, -0.261799f, 0.261799f);
 	if (location.direction & direction_t::Down) {
 		kinematics.accel_angle(glm::half_pi<real_t>() + variation, 5.0f);
 	} else if (location.direction & direction_t::Up) {
@@ -131,8 +189,8 @@ void ai::frontier::ctor(entt::entity s, kontext_t& kontext) {
 
 	auto& sprite = kontext.assign_if<sprite_t>(s, res::anim::Frontier);
 	sprite.layer = 0.6f;
-	sprite.pivot = { 8.0f, 8.0f };
-	sprite.angle = rng::next(0.0f, glm::two_pi<real_t>());
+	auto& rotation = kontext.assign_if<sprite_rotation_t>(s, glm::vec2(8.0f, 8.0f));
+	rotation.angle = rng::next(rng_stream_t::Cosmetic, 0.0f, glm::two_pi<real_t>());
 
 	auto& health = kontext.assign_if<health_t>(s);
 	health.damage = 3;
@@ -144,31 +202,29 @@ void ai::frontier::ctor(entt::entity s, kontext_t& kontext) {
 }
 
 void ai::frontier::tick(entt::entity s, routine_tuple_t& rtp) {
-	auto& timer = rtp.kontext.get<actor_timer_t>(s);
-	auto& listener = rtp.kontext.get<liquid_listener_t>(s);
+	frontier_spin(s, rtp.kontext);
+	frontier_strike(s, rtp.kontext);
+}
 
-	if (listener.liquid != entt::null and rtp.kontext.valid(listener.liquid)) {
-		auto& location = rtp.kontext.get<location_t>(s);
-		location.position.y = rtp.kontext.get<liquid_body_t>(listener.liquid).hitbox.y;
+void ai::frontier::batch(const entt::entity* actors, arch_t count, routine_tuple_t& rtp) {
+	// Timers and spins first, as one uniform pass over the whole group
+	for (arch_t it = 0; it < count; ++it) {
+		frontier_spin(actors[it], rtp.kontext);
 	}
-
-	if (timer[0]-- <= 0 or weapons::damage_check(s, rtp.kontext)) {
-		rtp.kontext.dispose(s);
-	} else {
-		auto& sprite = rtp.kontext.get<sprite_t>(s);
-		sprite.angle = glm::mod(sprite.angle + 0.035f, glm::two_pi<real_t>());
+	for (arch_t it = 0; it < count; ++it) {
+		frontier_strike(actors[it], rtp.kontext);
 	}
 }
 
 void ai::toxitier::ctor(entt::entity s, kontext_t& kontext) {
 	auto& location = kontext.get<location_t>(s);
 	location.position -= 8.0f;
-	location.position.x += rng::next(-2.0f, 2.0f);
-	location.position.y += rng::next(-2.0f, 2.0f);
+	location.position.x += rng::next(rng_stream_t::Combat, -2.0f, 2.0f);
+	location.position.y += rng::next(rng_stream_t::Combat, -2.0f, 2.0f);
 	location.bounding = { 6.0f, 6.0f, 4.0f, 4.0f };
 
 	auto& kinematics = kontext.assign_if<kinematics_t>(s);
-	real_t variation = rng::next(-0.261799f, 0.261799f);
+	real_t variation = rng::next(rng_stream_t::Combat, -0.261799f, 0.261799f);
 
 	if (location.direction & direction_t::Down) {
 		kinematics.accel_angle(glm::half_pi<real_t>() + variation, 3.0f);
@@ -194,19 +250,16 @@ void ai::toxitier::ctor(entt::entity s, kontext_t& kontext) {
 }
 
 void ai::toxitier::tick(entt::entity s, routine_tuple_t& rtp) {
-	auto& kinematics = rtp.kontext.get<kinematics_t>(s);
-	auto& sprite = rtp.kontext.get<sprite_t>(s);
-	auto& timer = rtp.kontext.get<actor_timer_t>(s);
-	auto& listener = rtp.kontext.get<liquid_listener_t>(s);
+	toxitier_drift(s, rtp.kontext);
+	toxitier_strike(s, rtp.kontext);
+}
 
-	if (listener.liquid == entt::null or
-		!rtp.kontext.valid(listener.liquid) or
-		timer[0]-- <= 0 or
-		weapons::damage_check(s, rtp.kontext)) {
-		rtp.kontext.dispose(s);
-	} else {
-		kinematics.accel_y(-0.3f, 0.6f);
-		sprite.alpha = glm::clamp(sprite.alpha - 0.016f, 0.0f, 1.0f);
+void ai::toxitier::batch(const entt::entity* actors, arch_t count, routine_tuple_t& rtp) {
+	for (arch_t it = 0; it < count; ++it) {
+		toxitier_drift(actors[it], rtp.kontext);
+	}
+	for (arch_t it = 0; it < count; ++it) {
+		toxitier_strike(actors[it], rtp.kontext);
 	}
 }
 
@@ -343,9 +396,9 @@ void ai::holy_lance::tick(entt::entity s, routine_tuple_t& rtp) {
 				kinematics.velocity = glm::zero<glm::vec2>();
 				timer[0] = 0;
 				routine.state = 3;
-				auto& naomi_kinematics = rtp.kontext.get<kinematics_t>(rtp.naomi.get_actor());
-				naomi_kinematics.anchor = actor_center;
-				naomi_kinematics.tether = glm::distance(actor_center, naomi_center);
+				auto& naomi_tether = rtp.kontext.get<kinematics_tether_t>(rtp.naomi.get_actor());
+				naomi_tether.anchor = actor_center;
+				naomi_tether.length = glm::distance(actor_center, naomi_center);
 				return;
 			}
 			entt::entity actor = weapons::find_hooked(s, rtp.kontext);
@@ -355,9 +408,9 @@ void ai::holy_lance::tick(entt::entity s, routine_tuple_t& rtp) {
 				kinematics.velocity = glm::zero<glm::vec2>();
 				timer[0] = 0;
 				routine.state = 1;
-				auto& naomi_kinematics = rtp.kontext.get<kinematics_t>(rtp.naomi.get_actor());
-				naomi_kinematics.anchor = actor_center;
-				naomi_kinematics.tether = glm::distance(actor_center, naomi_center);
+				auto& naomi_tether = rtp.kontext.get<kinematics_tether_t>(rtp.naomi.get_actor());
+				naomi_tether.anchor = actor_center;
+				naomi_tether.length = glm::distance(actor_center, naomi_center);
 			}
 		} else {
 			rtp.kontext.dispose(s);
@@ -365,18 +418,18 @@ void ai::holy_lance::tick(entt::entity s, routine_tuple_t& rtp) {
 		break;
 	}
 	case 1: /* Actor Hooked */ {
-		auto& naomi_kinematics = rtp.kontext.get<kinematics_t>(rtp.naomi.get_actor());
+		auto& naomi_tether = rtp.kontext.get<kinematics_tether_t>(rtp.naomi.get_actor());
 		if (rtp.kontext.valid(header.attach)) {
 			auto& attach_location = rtp.kontext.get<location_t>(header.attach);
 			auto& attach_health = rtp.kontext.get<health_t>(header.attach);
 			if (attach_health.flags[health_t::Grappled] and attach_health.flags[health_t::Hookable]) {
 				location.position = attach_location.center() + location.bounding.center();
-				naomi_kinematics.anchor = location.center();
+				naomi_tether.anchor = location.center();
 				return;
 			}
 		}
 		routine.state = 2;
-		naomi_kinematics.tether = 0.0f;
+		naomi_tether.length = 0.0f;
 		break;
 	}
 	case 2: /* Return */ {
@@ -417,7 +470,7 @@ void ai::holy_tether::ctor(entt::entity s, kontext_t& kontext) {
 	auto& sprite = kontext.assign_if<sprite_t>(s, res::anim::HolyLance);
 	sprite.state = 1;
 	sprite.layer = 0.6f;
-	sprite.pivot = { 0.5f, 0.5f };
+	kontext.assign_if<sprite_rotation_t>(s, glm::vec2(0.5f, 0.5f));
 
 	kontext.assign_if<routine_t>(s, tick);
 }
@@ -435,7 +488,7 @@ void ai::holy_tether::tick(entt::entity s, routine_tuple_t& rtp) {
 			naomi_center.x - actor_center.x
 		);
 		location.position = naomi_center;
-		sprite.angle = angle;
+		rtp.kontext.get<sprite_rotation_t>(s).angle = angle;
 		sprite.scale = { glm::distance(naomi_center, actor_center), 1.0f };
 	} else {
 		rtp.kontext.dispose(s);
@@ -576,7 +629,7 @@ void ai::wolf_vulcan::ctor(entt::entity s, kontext_t& kontext) {
 	auto& sprite = kontext.assign_if<sprite_t>(s, res::anim::HolyLance);
 	sprite.state = 1;
 	sprite.layer = 0.6f;
-	sprite.pivot = { 0.5f, 0.5f };
+	kontext.assign_if<sprite_rotation_t>(s, glm::vec2(0.5f, 0.5f));
 
 	auto& health = kontext.assign_if<health_t>(s);
 	health.damage = 4;
@@ -604,7 +657,7 @@ void ai::wolf_vulcan::tick(entt::entity s, routine_tuple_t& rtp) {
 			location.position, angle
 		);
 		sprite.scale = { glm::distance(location.position, end_point), 1.0f };
-		sprite.angle = glm::atan(
+		rtp.kontext.get<sprite_rotation_t>(s).angle = glm::atan(
 			end_point.y - location.position.y,
 			end_point.x - location.position.x
 		);
@@ -695,3 +748,21 @@ LEVIATHAN_CTOR_TABLE_CREATE(weapons) {
 	LEVIATHAN_TABLE_PUSH(ai::wolf_vulcan::type, 	ai::wolf_vulcan::ctor);
 	LEVIATHAN_TABLE_PUSH(ai::austere::type, 		ai::austere::ctor);
 }
+
+LEVIATHAN_TICK_TABLE_CREATE(weapons) {
+	LEVIATHAN_TABLE_PUSH(ai::frontier::type, 		ai::frontier::tick);
+	LEVIATHAN_TABLE_PUSH(ai::toxitier::type, 		ai::toxitier::tick);
+	LEVIATHAN_TABLE_PUSH(ai::weak_hammer::type, 	ai::weak_hammer::tick);
+	LEVIATHAN_TABLE_PUSH(ai::strong_hammer::type, 	ai::strong_hammer::tick);
+	LEVIATHAN_TABLE_PUSH(ai::holy_lance::type, 		ai::holy_lance::tick);
+	LEVIATHAN_TABLE_PUSH(ai::holy_tether::type, 	ai::holy_tether::tick);
+	LEVIATHAN_TABLE_PUSH(ai::kannon::type, 			ai::kannon::tick);
+	LEVIATHAN_TABLE_PUSH(ai::nail_ray::type, 		ai::nail_ray::tick);
+	LEVIATHAN_TABLE_PUSH(ai::wolf_vulcan::type, 	ai::wolf_vulcan::tick);
+	LEVIATHAN_TABLE_PUSH(ai::austere::type, 		ai::austere::tick);
+}
+
+LEVIATHAN_BATCH_TABLE_CREATE(weapons) {
+	LEVIATHAN_TABLE_PUSH(ai::frontier::tick, 		ai::frontier::batch);
+	LEVIATHAN_TABLE_PUSH(ai::toxitier::tick, 		ai::toxitier::batch);
+}
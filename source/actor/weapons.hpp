@@ -14,11 +14,13 @@ namespace ai {
 		constexpr entt::hashed_string type = "frontier";
 		void ctor(entt::entity s, kontext_t& kontext);
 		void tick(entt::entity s, routine_tuple_t& rtp);
+		void batch(const entt::entity* actors, arch_t count, routine_tuple_t& rtp);
 	}
 	namespace toxitier {
 		constexpr entt::hashed_string type = "toxitier";
 		void ctor(entt::entity s, kontext_t& kontext);
 		void tick(entt::entity s, routine_tuple_t& rtp);
+		void batch(const entt::entity* actors, arch_t count, routine_tuple_t& rtp);
 	}
 	namespace weak_hammer {
 		constexpr entt::hashed_string type = "weak_hammer";
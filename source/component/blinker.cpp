@@ -10,7 +10,7 @@ void blinker_t::update(kontext_t& kontext, real64_t delta) {
 			blinker.timer -= delta;
 			if (sprite.state == blinker.first_state) {
 				if (blinker.timer <= 0.0) {
-					blinker.timer = static_cast<real64_t>(rng::next(0.5f, 3.0f));
+					blinker.timer = static_cast<real64_t>(rng::next(rng_stream_t::Cosmetic, 0.5f, 3.0f));
 					sprite.new_state(blinker.blink_state);
 				}
 			} else if (sprite.state == blinker.blink_state) {
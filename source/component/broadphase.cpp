@@ -0,0 +1,93 @@
+#include "./broadphase.hpp"
+#include "./kontext.hpp"
+#include "./location.hpp"
+#include "./health.hpp"
+
+namespace {
+	// Actors keep moving after the rebuild, so pad their cells a little
+	constexpr real_t kPadding = 8.0f;
+
+	rect_t pad(const rect_t& hitbox) {
+		return {
+			hitbox.x - kPadding,
+			hitbox.y - kPadding,
+			hitbox.w + kPadding * 2.0f,
+			hitbox.h + kPadding * 2.0f
+		};
+	}
+}
+
+void broadphase_t::reset() {
+	cells.clear();
+	this->clear();
+}
+
+void broadphase_t::clear() {
+	for (auto&& cell : cells) {
+		cell.second.clear();
+	}
+	bounds.clear();
+	minimum = glm::ivec2(std::numeric_limits<sint_t>::max());
+	maximum = glm::ivec2(std::numeric_limits<sint_t>::min());
+	length = 0;
+}
+
+void broadphase_t::insert(entt::entity actor, const rect_t& hitbox) {
+	const rect_t padded = pad(hitbox);
+	bounds[actor] = padded;
+	this->place(actor, padded);
+	++length;
+}
+
+void broadphase_t::refresh(entt::entity actor, const kontext_t& kontext) {
+	auto iter = bounds.find(actor);
+	if (iter == bounds.end() or !kontext.has<location_t>(actor)) {
+		return;
+	}
+	const rect_t hitbox = kontext.get<location_t>(actor).hitbox();
+	if (iter->second.contains(hitbox)) {
+		return;
+	}
+	// Moved past its padding, so pull it out of its old cells and place it again
+	const glm::ivec2 first = broadphase_t::cell(iter->second.left_top());
+	const glm::ivec2 last = broadphase_t::cell(iter->second.right_bottom());
+	for (sint_t y = first.y; y <= last.y; ++y) {
+		for (sint_t x = first.x; x <= last.x; ++x) {
+			auto& entries = cells[broadphase_t::key(x, y)];
+			for (arch_t it = 0; it < entries.size(); ++it) {
+				if (entries[it].actor == actor) {
+					entries[it] = entries.back();
+					entries.pop_back();
+					break;
+				}
+			}
+		}
+	}
+	iter->second = pad(hitbox);
+	this->place(actor, iter->second);
+}
+
+void broadphase_t::place(entt::entity actor, const rect_t& padded) {
+	const glm::ivec2 first = broadphase_t::cell(padded.left_top());
+	const glm::ivec2 last = broadphase_t::cell(padded.right_bottom());
+	for (sint_t y = first.y; y <= last.y; ++y) {
+		for (sint_t x = first.x; x <= last.x; ++x) {
+			cells[broadphase_t::key(x, y)].push_back({ actor, padded });
+		}
+	}
+	minimum = glm::min(minimum, first);
+	maximum = glm::max(maximum, last);
+}
+
+void broadphase_t::handle(kontext_t& kontext) {
+	auto& broadphase = kontext.get_broadphase();
+	broadphase.clear();
+	kontext.slice<location_t, health_t>().each([&broadphase](entt::entity actor, const location_t& location, const health_t&) {
+		broadphase.insert(actor, location.hitbox());
+	});
+	kontext.slice<location_t, actor_trigger_t>().each([&kontext, &broadphase](entt::entity actor, const location_t& location, const actor_trigger_t&) {
+		if (!kontext.has<health_t>(actor)) {
+			broadphase.insert(actor, location.hitbox());
+		}
+	});
+}
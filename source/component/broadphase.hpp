@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <functional>
+#include <unordered_map>
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "../utility/rect.hpp"
+
+struct kontext_t;
+
+struct broadphase_t : public not_copyable_t {
+public:
+	broadphase_t() = default;
+	broadphase_t(broadphase_t&&) noexcept = default;
+	broadphase_t& operator=(broadphase_t&&) noexcept = default;
+	~broadphase_t() = default;
+public:
+	void reset();
+	void clear();
+	void insert(entt::entity actor, const rect_t& hitbox);
+	void refresh(entt::entity actor, const kontext_t& kontext);
+	template<typename Func>
+	void query(const rect_t& zone, Func&& func) const;
+	template<typename Filter>
+	entt::entity nearest(const glm::vec2& center, Filter&& filter) const;
+public:
+	static void handle(kontext_t& kontext);
+	static glm::ivec2 cell(const glm::vec2& position);
+	static constexpr sint_t CellSize = 64;
+private:
+	struct entry_t {
+	public:
+		entt::entity actor { entt::null };
+		rect_t hitbox {};
+	};
+	static uint64_t key(sint_t x, sint_t y);
+	void place(entt::entity actor, const rect_t& padded);
+private:
+	std::unordered_map<uint64_t, std::vector<entry_t> > cells {};
+	std::unordered_map<entt::entity, rect_t> bounds {};
+	glm::ivec2 minimum {};
+	glm::ivec2 maximum {};
+	arch_t length { 0 };
+};
+
+inline glm::ivec2 broadphase_t::cell(const glm::vec2& position) {
+	return glm::ivec2(glm::floor(position / static_cast<real_t>(broadphase_t::CellSize)));
+}
+
+inline uint64_t broadphase_t::key(sint_t x, sint_t y) {
+	return
+		(static_cast<uint64_t>(static_cast<uint_t>(x)) << 32) |
+		static_cast<uint64_t>(static_cast<uint_t>(y));
+}
+
+template<typename Func>
+inline void broadphase_t::query(const rect_t& zone, Func&& func) const {
+	if (length == 0) {
+		return;
+	}
+	const glm::ivec2 first = glm::max(broadphase_t::cell(zone.left_top()), minimum);
+	const glm::ivec2 last = glm::min(broadphase_t::cell(zone.right_bottom()), maximum);
+	for (sint_t y = first.y; y <= last.y; ++y) {
+		for (sint_t x = first.x; x <= last.x; ++x) {
+			auto iter = cells.find(broadphase_t::key(x, y));
+			if (iter == cells.end()) {
+				continue;
+			}
+			for (auto&& entry : iter->second) {
+				if (entry.hitbox.overlaps(zone)) {
+					// Only report from the cell holding the overlap's corner
+					const glm::ivec2 origin = broadphase_t::cell({
+						glm::max(zone.x, entry.hitbox.x),
+						glm::max(zone.y, entry.hitbox.y)
+					});
+					if (origin.x == x and origin.y == y) {
+						std::invoke(func, entry.actor);
+					}
+				}
+			}
+		}
+	}
+}
+
+template<typename Filter>
+inline entt::entity broadphase_t::nearest(const glm::vec2& center, Filter&& filter) const {
+	entt::entity result = entt::null;
+	if (length == 0) {
+		return result;
+	}
+	real_t distance = std::numeric_limits<real_t>::max();
+	const glm::ivec2 origin = broadphase_t::cell(center);
+	const sint_t rings = glm::max(
+		glm::max(origin.x - minimum.x, maximum.x - origin.x),
+		glm::max(origin.y - minimum.y, maximum.y - origin.y)
+	);
+	for (sint_t ring = 0; ring <= rings; ++ring) {
+		// Every cell in this ring is further than the best match
+		if (result != entt::null and static_cast<real_t>((ring - 1) * broadphase_t::CellSize) > distance) {
+			break;
+		}
+		for (sint_t y = origin.y - ring; y <= origin.y + ring; ++y) {
+			const bool_t edge = y == origin.y - ring or y == origin.y + ring;
+			const sint_t step = (edge or ring == 0) ? 1 : ring * 2;
+			for (sint_t x = origin.x - ring; x <= origin.x + ring; x += step) {
+				auto iter = cells.find(broadphase_t::key(x, y));
+				if (iter == cells.end()) {
+					continue;
+				}
+				for (auto&& entry : iter->second) {
+					const real_t span = glm::distance(center, entry.hitbox.center());
+					if (span < distance and std::invoke(filter, entry.actor)) {
+						distance = span;
+						result = entry.actor;
+					}
+				}
+			}
+		}
+	}
+	return result;
+}
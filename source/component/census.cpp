@@ -0,0 +1,184 @@
+#include "./census.hpp"
+#include "./common.hpp"
+#include "./location.hpp"
+#include "./kinematics.hpp"
+#include "./health.hpp"
+#include "./sprite.hpp"
+#include "./routine.hpp"
+#include "./blinker.hpp"
+#include "./liquid.hpp"
+#include "./particle-engine.hpp"
+
+#include "../utility/logger.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <type_traits>
+#include <fmt/format.h>
+#include <entt/entity/registry.hpp>
+
+namespace {
+	// Roughly a minute of ticks, so a forgotten recording can't grow without bound
+	constexpr arch_t kRecordLimit = 3600;
+	constexpr byte_t kCsvHeader[] = "frame,category,name,count,capacity,bytes,seconds\n";
+}
+
+void census_t::begin() {
+	++frame;
+	spawns = 0;
+	destroys = 0;
+	timings.fill(0.0);
+}
+
+void census_t::capture(const entt::registry& registry, const std::unordered_map<entt::id_type, std::vector<entt::entity> >& type_index, const particle_engine_t& particles) {
+	pools.clear();
+	this->sample<actor_header_t>(registry, "actor_header_t");
+	this->sample<actor_trigger_t>(registry, "actor_trigger_t");
+	this->sample<actor_timer_t>(registry, "actor_timer_t");
+	this->sample<actor_regional_t>(registry, "actor_regional_t");
+	this->sample<actor_dormant_t>(registry, "actor_dormant_t");
+	this->sample<location_t>(registry, "location_t");
+	this->sample<kinematics_t>(registry, "kinematics_t");
+	this->sample<kinematics_discrete_t>(registry, "kinematics_discrete_t");
+	this->sample<kinematics_tether_t>(registry, "kinematics_tether_t");
+	this->sample<sprite_t>(registry, "sprite_t");
+	this->sample<sprite_rotation_t>(registry, "sprite_rotation_t");
+	this->sample<health_t>(registry, "health_t");
+	this->sample<routine_t>(registry, "routine_t");
+	this->sample<blinker_t>(registry, "blinker_t");
+	this->sample<liquid_listener_t>(registry, "liquid_listener_t");
+	this->sample<liquid_body_t>(registry, "liquid_body_t");
+	pools.push_back({
+		"particles",
+		particles.size(),
+		particles.capacity(),
+		particles.capacity() * particle_bucket_t::Stride
+	});
+
+	types.clear();
+	for (auto&& [id, actors] : type_index) {
+		if (!actors.empty()) {
+			// Map names are interned by kontext_t, so every header's data stays valid
+			const auto& header = registry.get<actor_header_t>(*actors.begin());
+			types.push_back({ header.type.data(), actors.size() });
+		}
+	}
+	std::sort(types.begin(), types.end(), [](const census_type_t& lhv, const census_type_t& rhv) {
+		return lhv.count > rhv.count;
+	});
+
+	if (recording) {
+		if (rows.size() >= kRecordLimit) {
+			synao_log("Census recording reached {} frames and stopped.\n", kRecordLimit);
+			recording = false;
+			return;
+		}
+		std::string row = fmt::format("{},tick,spawns,{},0,0,0\n{},tick,destroys,{},0,0,0\n", frame, spawns, frame, destroys);
+		for (arch_t it = 0; it < census_system_t::Total; ++it) {
+			row += fmt::format("{},system,{},0,0,0,{}\n", frame, census_t::name(static_cast<census_system_t>(it)), timings[it]);
+		}
+		for (auto&& pool : pools) {
+			row += fmt::format("{},pool,{},{},{},{},0\n", frame, pool.name, pool.size, pool.capacity, pool.bytes);
+		}
+		for (auto&& type : types) {
+			row += fmt::format("{},type,{},{},0,0,0\n", frame, type.name, type.count);
+		}
+		rows.push_back(std::move(row));
+	}
+}
+
+void census_t::enable(bool_t enabled) {
+	this->enabled = enabled;
+}
+
+void census_t::record(bool_t recording) {
+	if (recording and !this->recording) {
+		rows.clear();
+	}
+	this->recording = recording;
+}
+
+bool census_t::write(const std::string& path) const {
+	std::ofstream ofs { path, std::ios::binary };
+	if (!ofs.is_open()) {
+		synao_log("Failed to write census file: {}!\n", path);
+		return false;
+	}
+	ofs.write(kCsvHeader, sizeof(kCsvHeader) - 1);
+	for (auto&& row : rows) {
+		ofs.write(row.data(), row.size());
+	}
+	synao_log("Wrote {} census frames to {}.\n", rows.size(), path);
+	return true;
+}
+
+bool census_t::is_enabled() const {
+	return enabled;
+}
+
+bool census_t::is_recording() const {
+	return recording;
+}
+
+arch_t census_t::get_frame() const {
+	return frame;
+}
+
+arch_t census_t::get_spawns() const {
+	return spawns;
+}
+
+arch_t census_t::get_destroys() const {
+	return destroys;
+}
+
+real64_t census_t::get_timing(census_system_t system) const {
+	return timings[system];
+}
+
+const std::vector<census_pool_t>& census_t::get_pools() const {
+	return pools;
+}
+
+const std::vector<census_type_t>& census_t::get_types() const {
+	return types;
+}
+
+const byte_t* census_t::name(census_system_t system) {
+	switch (system) {
+	case census_system_t::Flush:
+		return "Flush";
+	case census_system_t::Activate:
+		return "Activate";
+	case census_system_t::Kinematics:
+		return "Kinematics";
+	case census_system_t::Particles:
+		return "Particles";
+	case census_system_t::Broadphase:
+		return "Broadphase";
+	case census_system_t::Routines:
+		return "Routines";
+	case census_system_t::Health:
+		return "Health";
+	case census_system_t::Liquid:
+		return "Liquid";
+	default:
+		break;
+	}
+	return "Unknown";
+}
+
+template<typename Component>
+void census_t::sample(const entt::registry& registry, const byte_t* name) {
+	// Each stored component also costs one entity in its pool's packed array
+	const arch_t stride = std::is_empty<Component>::value ?
+		sizeof(entt::entity) :
+		sizeof(Component) + sizeof(entt::entity);
+	const arch_t capacity = registry.capacity<Component>();
+	pools.push_back({
+		name,
+		registry.size<Component>(),
+		capacity,
+		capacity * stride
+	});
+}
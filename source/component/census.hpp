@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <entt/entity/fwd.hpp>
+
+#include "../types.hpp"
+
+struct particle_engine_t;
+
+namespace __enum_census_system {
+	enum type : arch_t {
+		Flush,
+		Activate,
+		Kinematics,
+		Particles,
+		Broadphase,
+		Routines,
+		Health,
+		Liquid,
+		Total
+	};
+}
+
+using census_system_t = __enum_census_system::type;
+
+struct census_pool_t {
+public:
+	const byte_t* name { nullptr };
+	arch_t size { 0 };
+	arch_t capacity { 0 };
+	arch_t bytes { 0 };
+};
+
+struct census_type_t {
+public:
+	const byte_t* name { nullptr };
+	arch_t count { 0 };
+};
+
+struct census_t : public not_copyable_t {
+public:
+	census_t() = default;
+	census_t(census_t&&) noexcept = default;
+	census_t& operator=(census_t&&) noexcept = default;
+	~census_t() = default;
+public:
+	void begin();
+	void spawned();
+	void destroyed();
+	void measure(census_system_t system, real64_t seconds);
+	void capture(const entt::registry& registry, const std::unordered_map<entt::id_type, std::vector<entt::entity> >& type_index, const particle_engine_t& particles);
+	void enable(bool_t enabled);
+	void record(bool_t recording);
+	bool write(const std::string& path) const;
+	bool is_enabled() const;
+	bool is_recording() const;
+	arch_t get_frame() const;
+	arch_t get_spawns() const;
+	arch_t get_destroys() const;
+	real64_t get_timing(census_system_t system) const;
+	const std::vector<census_pool_t>& get_pools() const;
+	const std::vector<census_type_t>& get_types() const;
+public:
+	static const byte_t* name(census_system_t system);
+private:
+	template<typename Component>
+	void sample(const entt::registry& registry, const byte_t* name);
+private:
+	bool_t enabled { false };
+	bool_t recording { false };
+	arch_t frame { 0 };
+	arch_t spawns { 0 };
+	arch_t destroys { 0 };
+	std::array<real64_t, census_system_t::Total> timings {};
+	std::vector<census_pool_t> pools {};
+	std::vector<census_type_t> types {};
+	std::vector<std::string> rows {};
+};
+
+inline void census_t::spawned() {
+	++spawns;
+}
+
+inline void census_t::destroyed() {
+	++destroys;
+}
+
+inline void census_t::measure(census_system_t system, real64_t seconds) {
+	timings[system] += seconds;
+}
@@ -51,24 +51,37 @@ public:
 		Hostile,
 		InteractionEvent,
 		DeathEvent,
+		AlwaysActive,
 		TotalFlags
 	};
 public:
 	actor_trigger_t(sint_t identity, const std::bitset<flags_t::TotalFlags>& bitmask) :
 		identity(identity),
-		bitmask(bitmask) {}
+		bitmask(static_cast<uint8_t>(bitmask.to_ulong())) {}
 	actor_trigger_t(sint_t identity, arch_t flags) :
 		identity(identity),
-		bitmask(flags) {}
+		bitmask(static_cast<uint8_t>(flags)) {}
 	actor_trigger_t() = default;
 	actor_trigger_t(const actor_trigger_t&) = default;
 	actor_trigger_t& operator=(const actor_trigger_t&) = default;
 	actor_trigger_t(actor_trigger_t&&) noexcept = default;
 	actor_trigger_t& operator=(actor_trigger_t&&) noexcept = default;
 	~actor_trigger_t() = default;
+public:
+	bool test(arch_t flag) const {
+		return (bitmask >> flag) & 1;
+	}
+	void set(arch_t flag, bool value) {
+		if (value) {
+			bitmask |= static_cast<uint8_t>(1 << flag);
+		} else {
+			bitmask &= static_cast<uint8_t>(~(1 << flag));
+		}
+	}
 public:
 	sint_t identity { 0 };
-	std::bitset<flags_t::TotalFlags> bitmask { 0 };
+	// One byte instead of a std::bitset keeps the whole trigger in eight bytes
+	uint8_t bitmask { 0 };
 };
 
 struct actor_spawn_t {
@@ -117,6 +130,15 @@ public:
 	std::bitset<actor_trigger_t::TotalFlags> bitmask { 0 };
 };
 
+// Placed by the map, so it sleeps while outside the activation region
+struct actor_regional_t {};
+
+// Skipped by routines, kinematics, animation and health until woken
+struct actor_dormant_t {};
+
+// Marked by dispose, so nothing ticks, draws or finds the actor before the flush destroys it
+struct actor_disposed_t {};
+
 struct actor_timer_t {
 public:
 	actor_timer_t() = default;
@@ -126,14 +148,14 @@ public:
 	actor_timer_t& operator=(actor_timer_t&&) = default;
 	~actor_timer_t() = default;
 public:
-	sint64_t& operator[](arch_t index) {
+	sint_t& operator[](arch_t index) {
 		return data[index];
 	}
-	const sint64_t& operator[](arch_t index) const {
+	const sint_t& operator[](arch_t index) const {
 		return data[index];
 	}
 private:
-	std::array<sint64_t, 4> data {
+	std::array<sint_t, 4> data {
 		0, 0, 0, 0
 	};
 };
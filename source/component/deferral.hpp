@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <entt/entity/registry.hpp>
+
+#include "../types.hpp"
+
+// Component changes recorded mid-tick and applied together at the next flush
+struct deferral_i {
+public:
+	virtual ~deferral_i() = default;
+	virtual void apply(entt::registry& registry) = 0;
+	virtual void clear() = 0;
+};
+
+template<typename Component>
+struct deferral_t : public deferral_i, public not_copyable_t {
+public:
+	deferral_t() = default;
+	~deferral_t() = default;
+public:
+	template<typename ...Args>
+	void emplace(entt::entity actor, Args&& ...args);
+	void remove(entt::entity actor);
+	void apply(entt::registry& registry) override;
+	void clear() override;
+public:
+	static arch_t index();
+private:
+	// Empty values are removals, so emplaces and removes stay in call order
+	std::vector<std::pair<entt::entity, std::optional<Component> > > commands {};
+};
+
+struct deferral_index_t {
+public:
+	static arch_t next() {
+		static arch_t count = 0;
+		return count++;
+	}
+};
+
+template<typename Component>
+template<typename ...Args>
+inline void deferral_t<Component>::emplace(entt::entity actor, Args&& ...args) {
+	commands.emplace_back(
+		std::piecewise_construct,
+		std::forward_as_tuple(actor),
+		std::forward_as_tuple(std::in_place, std::forward<Args>(args)...)
+	);
+}
+
+template<typename Component>
+inline void deferral_t<Component>::remove(entt::entity actor) {
+	commands.emplace_back(actor, std::nullopt);
+}
+
+template<typename Component>
+inline void deferral_t<Component>::apply(entt::registry& registry) {
+	for (auto&& [actor, value] : commands) {
+		if (!registry.valid(actor)) {
+			continue;
+		}
+		if (value) {
+			if constexpr (std::is_empty_v<Component>) {
+				registry.emplace_or_replace<Component>(actor);
+			} else {
+				registry.emplace_or_replace<Component>(actor, std::move(*value));
+			}
+		} else if (registry.all_of<Component>(actor)) {
+			registry.remove<Component>(actor);
+		}
+	}
+	commands.clear();
+}
+
+template<typename Component>
+inline void deferral_t<Component>::clear() {
+	commands.clear();
+}
+
+template<typename Component>
+inline arch_t deferral_t<Component>::index() {
+	static const arch_t value = deferral_index_t::next();
+	return value;
+}
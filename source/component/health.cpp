@@ -29,12 +29,12 @@ void health_t::attack(health_t& victim) const {
 
 void health_t::handle(audio_t& audio, receiver_t& receiver, naomi_state_t& naomi, kontext_t& kontext) {
 	const auto& naomi_location = kontext.get<location_t>(naomi.get_actor());
-	kontext.slice<actor_header_t, health_t, location_t>().each([&audio, &receiver, &naomi, &kontext, &naomi_location](entt::entity actor, const actor_header_t&, health_t& health, const location_t& location) {
+	kontext.awake<actor_header_t, health_t, location_t>().each([&audio, &receiver, &naomi, &kontext, &naomi_location](entt::entity actor, const actor_header_t&, health_t& health, const location_t& location) {
 		if (health.current <= 0) {
 			if (kontext.has<actor_trigger_t>(actor)) {
 				auto& trigger = kontext.get<actor_trigger_t>(actor);
-				if (trigger.bitmask[actor_trigger_t::DeathEvent]) {
-					trigger.bitmask[actor_trigger_t::DeathEvent] = false;
+				if (trigger.test(actor_trigger_t::DeathEvent)) {
+					trigger.set(actor_trigger_t::DeathEvent, false);
 					receiver.run_event(trigger.identity);
 				}
 			}
@@ -2,18 +2,40 @@
 #include "./location.hpp"
 #include "./kontext.hpp"
 
+#include <algorithm>
 #include <glm/common.hpp>
 #include <glm/geometric.hpp>
 #include <glm/trigonometric.hpp>
 #include <glm/gtc/constants.hpp>
 
 #include "../field/collision.hpp"
+#include "../field/tilemap.hpp"
+#include "../resource/vfs.hpp"
+#include "../utility/thread-pool.hpp"
+
+namespace {
+	constexpr arch_t kChunkSize = 128;
+	// Flags a noclip body drops when it moves along each axis
+	const std::bitset<phy_t::Total> kHoriSides {
+		(1 << phy_t::Right) |
+		(1 << phy_t::Left)
+	};
+	const std::bitset<phy_t::Total> kVertSides {
+		(1 << phy_t::Top) |
+		(1 << phy_t::Bottom) |
+		(1 << phy_t::Sloped) |
+		(1 << phy_t::WillDrop)
+	};
+}
 
 void kinematics_t::reset() {
 	flags.reset();
 	velocity = glm::zero<glm::vec2>();
+}
+
+void kinematics_tether_t::reset() {
 	anchor = glm::zero<glm::vec2>();
-	tether = 0.0f;
+	length = 0.0f;
 }
 
 void kinematics_t::accel_angle(real_t angle, real_t speed) {
@@ -59,36 +81,104 @@ bool kinematics_t::any_side() const {
 	return this->hori_sides() or this->vert_sides();
 }
 
-void kinematics_t::handle(kontext_t& kontext, const tilemap_t& tilemap) {
-	kontext.slice<kinematics_t, location_t>().each([&tilemap](entt::entity, kinematics_t& kinematics, location_t& location) {
-		if (kinematics.velocity.x != 0.0f) {
-			kinematics_t::do_x(location, kinematics, kinematics.velocity.x, tilemap);
-		}
-		if (kinematics.velocity.y != 0.0f) {
-			kinematics_t::do_y(location, kinematics, kinematics.velocity.y, tilemap);
+void kinematics_t::handle(kontext_t& kontext, tilemap_t& tilemap) {
+	auto group = kontext.bodies();
+	// Keeps noclip bodies packed together at one end of the group. Insertion
+	// sort is almost free when only a few flags changed since the last tick
+	group.sort<kinematics_t>(kinematics_t::compare, entt::insertion_sort{});
+	const entt::entity* actors = group.data();
+	kinematics_t* kinematics = group.raw<kinematics_t>();
+	location_t* locations = group.raw<location_t>();
+	const arch_t length = group.size();
+	arch_t passive = 0;
+	for (arch_t it = 0; it < length; ++it) {
+		passive += kinematics[it].flags[phy_t::Noclip] ? 1 : 0;
+	}
+	const bool_t leading = passive > 0 and kinematics[0].flags[phy_t::Noclip];
+	const arch_t first = leading ? passive : 0;
+	const arch_t last = leading ? length : length - passive;
+	if (leading) {
+		kinematics_t::drift(locations, kinematics, 0, passive);
+	} else {
+		kinematics_t::drift(locations, kinematics, last, length);
+	}
+	if (passive > 0) {
+		kontext.slice<kinematics_tether_t>().each([&group](entt::entity actor, const kinematics_tether_t& tether) {
+			if (tether.length > 0.0f and group.contains(actor)) {
+				auto& kinematics = group.get<kinematics_t>(actor);
+				if (kinematics.flags[phy_t::Noclip]) {
+					kinematics_t::do_angle(group.get<location_t>(actor), kinematics, tether, kinematics.velocity);
+				}
+			}
+		});
+	}
+	// Placed actors only wake up near the camera, where regions are streamed in already.
+	// Spawned ones can roam anywhere, so their regions are requested from here. Either
+	// kind holds still until the regions under it are resident, before any worker reads them
+	std::vector<arch_t> held {};
+	for (arch_t it = first; it < last; ++it) {
+		const rect_t hitbox = locations[it].hitbox();
+		const bool_t ready = kontext.has<actor_regional_t>(actors[it]) ?
+			tilemap.resident(hitbox, kinematics[it].velocity) :
+			tilemap.prepare(hitbox, kinematics[it].velocity);
+		if (!ready) {
+			held.push_back(it);
 		}
-		if (kinematics.tether > 0.0f) {
-			kinematics_t::do_angle(location, kinematics, kinematics.velocity);
+	}
+	// Read-only lookups on a const registry never create pools, so workers can share it
+	const entt::registry& registry = *kontext.backend();
+	auto process = [actors, kinematics, locations, &registry, &tilemap, &held](arch_t first, arch_t last) {
+		for (arch_t it = first; it < last; ++it) {
+			if (!held.empty() and std::binary_search(held.begin(), held.end(), it)) {
+				continue;
+			}
+			// Disposed bodies wait for the flush where they stand
+			if (registry.all_of<actor_disposed_t>(actors[it])) {
+				continue;
+			}
+			auto discrete = registry.try_get<kinematics_discrete_t>(actors[it]);
+			kinematics_t::step(
+				locations[it], kinematics[it], tilemap,
+				discrete ? &discrete->bounding : nullptr,
+				registry.try_get<kinematics_tether_t>(actors[it])
+			);
 		}
-	});
+	};
+	thread_pool_t* workers = vfs_t::multithreaded() ? vfs_t::workers() : nullptr;
+	if (!workers or last - first <= kChunkSize) {
+		std::invoke(process, first, last);
+		return;
+	}
+	// Every actor only writes its own components and only reads the tilemap,
+	// so chunks give the same results as the serial path in any order
+	std::vector<std::future<void> > futures {};
+	arch_t index = first;
+	while (last - index > kChunkSize) {
+		futures.push_back(workers->push(process, index, index + kChunkSize));
+		index += kChunkSize;
+	}
+	std::invoke(process, index, last);
+	for (auto&& future : futures) {
+		workers->wait(future);
+	}
 }
 
-void kinematics_t::handle(location_t& location, kinematics_t& kinematics, const tilemap_t& tilemap, glm::vec2 inertia) {
+void kinematics_t::handle(location_t& location, kinematics_t& kinematics, const tilemap_t& tilemap, glm::vec2 inertia, const rect_t* discrete, const kinematics_tether_t* tether) {
 	if (inertia.x != 0.0f) {
-		kinematics_t::do_x(location, kinematics, inertia.x, tilemap);
+		kinematics_t::do_x(location, kinematics, inertia.x, tilemap, discrete);
 	}
 	if (inertia.y != 0.0f) {
-		kinematics_t::do_y(location, kinematics, inertia.y, tilemap);
+		kinematics_t::do_y(location, kinematics, inertia.y, tilemap, discrete);
 	}
-	if (kinematics.tether > 0.0f) {
-		kinematics_t::do_angle(location, kinematics, inertia);
+	if (tether and tether->length > 0.0f) {
+		kinematics_t::do_angle(location, kinematics, *tether, inertia);
 	}
 }
 
-rect_t kinematics_t::predict(const location_t& location, side_t side, real_t inertia, const std::optional<rect_t>& discrete) {
+rect_t kinematics_t::predict(const location_t& location, side_t side, real_t inertia, const rect_t* discrete) {
 	switch (side) {
 	case side_t::Left: {
-		if (discrete.has_value()) {
+		if (discrete) {
 			return {
 				location.position.x + discrete->x + inertia,
 				location.position.y + discrete->y,
@@ -104,7 +194,7 @@ rect_t kinematics_t::predict(const location_t& location, side_t side, real_t ine
 		};
 	}
 	case side_t::Right: {
-		if (discrete.has_value()) {
+		if (discrete) {
 			return {
 				location.position.x + discrete->x + discrete->w / 2.0f,
 				location.position.y + discrete->y,
@@ -138,20 +228,48 @@ rect_t kinematics_t::predict(const location_t& location, side_t side, real_t ine
 	}
 }
 
-void kinematics_t::do_angle(location_t& location, kinematics_t& kinematics, glm::vec2& inertia) {
+void kinematics_t::drift(location_t* locations, kinematics_t* kinematics, arch_t first, arch_t last) {
+	// Plain adds over contiguous arrays with no tile queries, so this vectorizes
+	for (arch_t it = first; it < last; ++it) {
+		locations[it].position += kinematics[it].velocity;
+	}
+	for (arch_t it = first; it < last; ++it) {
+		auto& body = kinematics[it];
+		if (body.velocity.x != 0.0f) {
+			body.flags &= ~kHoriSides;
+		}
+		if (body.velocity.y != 0.0f) {
+			body.flags &= ~kVertSides;
+		}
+	}
+}
+
+void kinematics_t::step(location_t& location, kinematics_t& kinematics, const tilemap_t& tilemap, const rect_t* discrete, const kinematics_tether_t* tether) {
+	if (kinematics.velocity.x != 0.0f) {
+		kinematics_t::do_x(location, kinematics, kinematics.velocity.x, tilemap, discrete);
+	}
+	if (kinematics.velocity.y != 0.0f) {
+		kinematics_t::do_y(location, kinematics, kinematics.velocity.y, tilemap, discrete);
+	}
+	if (tether and tether->length > 0.0f) {
+		kinematics_t::do_angle(location, kinematics, *tether, kinematics.velocity);
+	}
+}
+
+void kinematics_t::do_angle(location_t& location, kinematics_t& kinematics, const kinematics_tether_t& tether, glm::vec2& inertia) {
 	glm::vec2 test_point = location.position + location.bounding.center();
-	real_t distance = glm::distance(test_point, kinematics.anchor);
-	kinematics.flags[phy_t::Constrained] = distance > kinematics.tether;
+	real_t distance = glm::distance(test_point, tether.anchor);
+	kinematics.flags[phy_t::Constrained] = distance > tether.length;
 	if (kinematics.flags[phy_t::Constrained]) {
 		real_t angle = glm::atan(
-			kinematics.anchor.y - test_point.y,
-			kinematics.anchor.x - test_point.x
+			tether.anchor.y - test_point.y,
+			tether.anchor.x - test_point.x
 		);
 		glm::vec2 normal { glm::cos(angle), glm::sin(angle) };
-		test_point += (normal * (distance - kinematics.tether));
+		test_point += (normal * (distance - tether.length));
 		location.position = test_point - location.bounding.center();
 		if (inertia != glm::zero<glm::vec2>()) {
-			normal = glm::normalize(test_point - kinematics.anchor);
+			normal = glm::normalize(test_point - tether.anchor);
 			const glm::vec2 perpendicular { normal.y, -normal.x };
 			const glm::vec2 redirection = perpendicular * glm::dot(perpendicular, inertia);
 			if (redirection != glm::zero<glm::vec2>()) {
@@ -161,13 +279,13 @@ void kinematics_t::do_angle(location_t& location, kinematics_t& kinematics, glm:
 	}
 }
 
-void kinematics_t::do_x(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap) {
+void kinematics_t::do_x(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap, const rect_t* discrete) {
 	if (!kinematics.flags[phy_t::Noclip]) {
 		// Check side determined by inertia
 		side_t side = inertia > 0.0f ? side_t::Right : side_t::Left;
 		{
 			auto info = collision::attempt(
-				kinematics_t::predict(location, side, inertia, kinematics.discrete),
+				kinematics_t::predict(location, side, inertia, discrete),
 				kinematics.flags,
 				tilemap,
 				side
@@ -188,7 +306,7 @@ void kinematics_t::do_x(location_t& location, kinematics_t& kinematics, real_t i
 		side_t opposing = side_fn::opposing(side);
 		{
 			auto info = collision::attempt(
-				kinematics_t::predict(location, opposing, 0.0f, kinematics.discrete),
+				kinematics_t::predict(location, opposing, 0.0f, discrete),
 				kinematics.flags,
 				tilemap,
 				opposing
@@ -205,13 +323,13 @@ void kinematics_t::do_x(location_t& location, kinematics_t& kinematics, real_t i
 	}
 }
 
-void kinematics_t::do_y(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap) {
+void kinematics_t::do_y(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap, const rect_t* discrete) {
 	if (!kinematics.flags[phy_t::Noclip]) {
 		// Check side determined by inertia
 		side_t side = inertia > 0.0f ? side_t::Bottom : side_t::Top;
 		{
 			auto info = collision::attempt(
-				kinematics_t::predict(location, side, inertia, kinematics.discrete),
+				kinematics_t::predict(location, side, inertia, discrete),
 				kinematics.flags,
 				tilemap,
 				side
@@ -255,7 +373,7 @@ void kinematics_t::do_y(location_t& location, kinematics_t& kinematics, real_t i
 		side_t opposing = side_fn::opposing(side);
 		{
 			auto info = collision::attempt(
-				kinematics_t::predict(location, opposing, 0.0f, kinematics.discrete),
+				kinematics_t::predict(location, opposing, 0.0f, discrete),
 				kinematics.flags,
 				tilemap,
 				opposing
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <optional>
-
 #include "./common.hpp"
 
 #include "../utility/rect.hpp"
@@ -9,6 +7,7 @@
 struct tilemap_t;
 struct location_t;
 struct kontext_t;
+struct kinematics_tether_t;
 
 struct kinematics_t {
 public:
@@ -31,17 +30,51 @@ public:
 	bool vert_sides() const;
 	bool any_side() const;
 public:
-	static void handle(kontext_t& kontext, const tilemap_t& tilemap);
-	static void handle(location_t& location, kinematics_t& kinematics, const tilemap_t& tilemap, glm::vec2 inertia);
-	static rect_t predict(const location_t& location, side_t side, real_t inertia, const std::optional<rect_t>& discrete = std::nullopt);
+	static void handle(kontext_t& kontext, tilemap_t& tilemap);
+	static void handle(location_t& location, kinematics_t& kinematics, const tilemap_t& tilemap, glm::vec2 inertia, const rect_t* discrete = nullptr, const kinematics_tether_t* tether = nullptr);
+	static rect_t predict(const location_t& location, side_t side, real_t inertia, const rect_t* discrete = nullptr);
+	static bool compare(const kinematics_t& lhv, const kinematics_t& rhv) {
+		return lhv.flags[phy_t::Noclip] < rhv.flags[phy_t::Noclip];
+	}
 private:
-	static void do_angle(location_t& location, kinematics_t& kinematics, glm::vec2& inertia);
-	static void do_x(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap);
-	static void do_y(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap);
+	static void drift(location_t* locations, kinematics_t* kinematics, arch_t first, arch_t last);
+	static void step(location_t& location, kinematics_t& kinematics, const tilemap_t& tilemap, const rect_t* discrete, const kinematics_tether_t* tether);
+	static void do_angle(location_t& location, kinematics_t& kinematics, const kinematics_tether_t& tether, glm::vec2& inertia);
+	static void do_x(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap, const rect_t* discrete);
+	static void do_y(location_t& location, kinematics_t& kinematics, real_t inertia, const tilemap_t& tilemap, const rect_t* discrete);
 public:
 	std::bitset<phy_t::Total> flags { 0 };
-	std::optional<rect_t> discrete { std::nullopt };
 	glm::vec2 velocity {};
+};
+
+// Cold data for the few actors that collide with a different box than
+// their hitbox, kept out of kinematics_t so the integration loop stays small
+struct kinematics_discrete_t {
+public:
+	kinematics_discrete_t(const rect_t& bounding) :
+		bounding(bounding) {}
+	kinematics_discrete_t() = default;
+	kinematics_discrete_t(const kinematics_discrete_t&) = default;
+	kinematics_discrete_t& operator=(const kinematics_discrete_t&) = default;
+	kinematics_discrete_t(kinematics_discrete_t&&) noexcept = default;
+	kinematics_discrete_t& operator=(kinematics_discrete_t&&) noexcept = default;
+	~kinematics_discrete_t() = default;
+public:
+	rect_t bounding {};
+};
+
+// Grapple constraint, only attached to actors that can swing from a hook
+struct kinematics_tether_t {
+public:
+	kinematics_tether_t() = default;
+	kinematics_tether_t(const kinematics_tether_t&) = default;
+	kinematics_tether_t& operator=(const kinematics_tether_t&) = default;
+	kinematics_tether_t(kinematics_tether_t&&) noexcept = default;
+	kinematics_tether_t& operator=(kinematics_tether_t&&) noexcept = default;
+	~kinematics_tether_t() = default;
+public:
+	void reset();
+public:
 	glm::vec2 anchor {};
-	real_t tether { 0.0f };
+	real_t length { 0.0f };
 };
@@ -7,18 +7,157 @@
 #include "./blinker.hpp"
 #include "./liquid.hpp"
 
-#include "../actor/particles.hpp"
+#include "../field/camera.hpp"
 #include "../field/properties.hpp"
 #include "../menu/headsup-gui.hpp"
 #include "../menu/meta-state.hpp"
+#include "../resource/vfs.hpp"
 #include "../system/kernel.hpp"
 #include "../system/receiver.hpp"
+#include "../system/snapshot.hpp"
 #include "../utility/logger.hpp"
+#include "../utility/watch.hpp"
 
+#include <limits>
+#include <cstdint>
+#include <algorithm>
 #include <angelscript.h>
+#include <angelscript/scriptarray.h>
+#include <entt/entity/snapshot.hpp>
 #include <glm/gtc/constants.hpp>
 #include <tmxlite/ObjectGroup.hpp>
 
+namespace {
+	// Written for ticks missing from the tick table, which no restore will accept
+	constexpr entt::id_type kUnnamedTick = std::numeric_limits<entt::id_type>::max();
+
+	constexpr byte_t kIdentityArray[] = "std::array<sint32_t>";
+	constexpr byte_t kPositionArray[] = "std::array<real32_t>";
+
+	// Arrays handed back to scripts belong to the engine running the caller
+	CScriptArray* make_array(const byte_t* declaration, arch_t length) {
+		asIScriptContext* context = asGetActiveContext();
+		if (!context) {
+			return nullptr;
+		}
+		asITypeInfo* type = context->GetEngine()->GetTypeInfoByDecl(declaration);
+		if (!type) {
+			return nullptr;
+		}
+		return CScriptArray::Create(type, static_cast<asUINT>(length));
+	}
+
+	struct kontext_output_t {
+	public:
+		void operator()(std::underlying_type<entt::entity>::type count) {
+			writer.value<uint64_t>(count);
+		}
+		void operator()(entt::entity actor) {
+			writer.value(actor);
+		}
+		template<typename Component>
+		void operator()(entt::entity actor, const Component& component) {
+			writer.value(actor);
+			writer.value(component);
+		}
+		void operator()(entt::entity actor, const actor_header_t& header) {
+			writer.value(actor);
+			writer.name(header.type);
+			writer.value(header.attach);
+		}
+		void operator()(entt::entity actor, const sprite_t& sprite) {
+			writer.value(actor);
+			writer.string(vfs_t::animation_name(sprite.file));
+			writer.value(sprite.timer);
+			writer.value(sprite.alpha);
+			writer.value(sprite.state);
+			writer.value(sprite.variation);
+			writer.value(sprite.mirroring);
+			writer.value(sprite.frame);
+			writer.value(sprite.layer);
+			writer.value(sprite.scale);
+		}
+		void operator()(entt::entity actor, const routine_t& routine) {
+			writer.value(actor);
+			writer.value(routine.state);
+			writer.value(kontext.routine_name(routine.tick));
+		}
+		void operator()(entt::entity actor, const liquid_listener_t& listener) {
+			writer.value(actor);
+			writer.value(listener.liquid);
+			writer.name(listener.particle);
+			writer.name(listener.sound);
+		}
+	public:
+		snapshot_writer_t& writer;
+		const kontext_t& kontext;
+	};
+
+	struct kontext_input_t {
+	public:
+		void operator()(std::underlying_type<entt::entity>::type& count) {
+			uint64_t literal = 0;
+			reader.value(literal);
+			// A broken buffer reads as empty instead of as a huge pool
+			count = reader.valid() ? static_cast<std::underlying_type<entt::entity>::type>(literal) : 0;
+		}
+		void operator()(entt::entity& actor) {
+			reader.value(actor);
+		}
+		template<typename Component>
+		void operator()(entt::entity& actor, Component& component) {
+			reader.value(actor);
+			reader.value(component);
+		}
+		void operator()(entt::entity& actor, actor_header_t& header) {
+			const std::string* name = nullptr;
+			reader.value(actor);
+			reader.name(name);
+			reader.value(header.attach);
+			header.type = name ? kontext.intern(*name) : entt::hashed_string {};
+		}
+		void operator()(entt::entity& actor, sprite_t& sprite) {
+			std::string name {};
+			reader.value(actor);
+			reader.string(name);
+			reader.value(sprite.timer);
+			reader.value(sprite.alpha);
+			reader.value(sprite.state);
+			reader.value(sprite.variation);
+			reader.value(sprite.mirroring);
+			reader.value(sprite.frame);
+			reader.value(sprite.layer);
+			reader.value(sprite.scale);
+			sprite.file = name.empty() ? nullptr : vfs_t::animation(name);
+		}
+		void operator()(entt::entity& actor, routine_t& routine) {
+			entt::id_type name = 0;
+			reader.value(actor);
+			reader.value(routine.state);
+			reader.value(name);
+			routine.tick = kontext.routine_tick(name);
+			if (name != 0 and !routine.tick) {
+				synao_log("Routine tick {} isn't known to this build!\n", name);
+				broken = true;
+			}
+		}
+		void operator()(entt::entity& actor, liquid_listener_t& listener) {
+			const std::string* particle = nullptr;
+			const std::string* sound = nullptr;
+			reader.value(actor);
+			reader.value(listener.liquid);
+			reader.name(particle);
+			reader.name(sound);
+			listener.particle = particle ? kontext.intern(*particle) : entt::hashed_string {};
+			listener.sound = sound ? kontext.intern(*sound) : entt::hashed_string {};
+		}
+	public:
+		snapshot_reader_t& reader;
+		kontext_t& kontext;
+		bool_t broken { false };
+	};
+}
+
 bool kontext_t::init(receiver_t& receiver, headsup_gui_t& headsup_gui) {
 	run_event = [&receiver](sint_t id) {
 		receiver.run_event(id);
@@ -29,10 +168,29 @@ bool kontext_t::init(receiver_t& receiver, headsup_gui_t& headsup_gui) {
 	push_meter = [&headsup_gui](sint_t current, sint_t maximum) {
 		headsup_gui.set_fight_values(current, maximum);
 	};
+	// Keep lookup indices in sync with the registry
+	registry.on_construct<actor_header_t>().connect<&kontext_t::attach_type>(*this);
+	registry.on_destroy<actor_header_t>().connect<&kontext_t::detach_type>(*this);
+	registry.on_construct<actor_trigger_t>().connect<&kontext_t::attach_identity>(*this);
+	registry.on_destroy<actor_trigger_t>().connect<&kontext_t::detach_identity>(*this);
+	// Owns the kinematics and location pools so bodies stay packed side by side
+	this->bodies();
 	if (!routine_ctor_generator_t::init(ctor_table)) {
 		synao_log("Actor constructor table generation failed!\n");
 		return false;
 	}
+	if (!routine_batch_generator_t::init(batch_table)) {
+		synao_log("Actor batch table generation failed!\n");
+		return false;
+	}
+	if (!routine_tick_generator_t::init(tick_table)) {
+		synao_log("Actor tick table generation failed!\n");
+		return false;
+	}
+	tick_names.clear();
+	for (auto&& [name, tick] : tick_table) {
+		tick_names[tick] = name;
+	}
 	synao_log("Kontext system is ready.\n");
 	return true;
 }
@@ -44,16 +202,71 @@ void kontext_t::reset() {
 		registry.destroy(actor);
 	}
 	spawn_commands.clear();
+	dispose_commands.clear();
+	for (auto&& deferral : change_commands) {
+		if (deferral) {
+			deferral->clear();
+		}
+	}
+	placed_spawns.clear();
+	broadphase.reset();
+	volumes.reset();
+	particles.reset();
 }
 
-void kontext_t::handle(const input_t& input, audio_t& audio, kernel_t& kernel, receiver_t& receiver, headsup_gui_t& headsup_gui, camera_t& camera, naomi_state_t& naomi, const tilemap_t& tilemap) {
+void kontext_t::handle(const input_t& input, audio_t& audio, kernel_t& kernel, receiver_t& receiver, headsup_gui_t& headsup_gui, camera_t& camera, naomi_state_t& naomi, tilemap_t& tilemap) {
+	census.begin();
+	watch_t watch {};
+	// Apply anything scripts or naomi recorded since the last tick
+	this->flush();
+	census.measure(census_system_t::Flush, watch.restart());
+	this->activate(camera);
+	census.measure(census_system_t::Activate, watch.restart());
 	kinematics_t::handle(*this, tilemap);
+	census.measure(census_system_t::Kinematics, watch.restart());
+	particles.handle(tilemap);
+	census.measure(census_system_t::Particles, watch.restart());
+	broadphase_t::handle(*this);
+	census.measure(census_system_t::Broadphase, watch.restart());
 	routine_t::handle(input, audio, kernel, receiver, headsup_gui, camera, naomi, *this, tilemap);
+	census.measure(census_system_t::Routines, watch.restart());
 	health_t::handle(audio, receiver, naomi, *this);
+	census.measure(census_system_t::Health, watch.restart());
 	liquid::handle(audio, *this);
+	census.measure(census_system_t::Liquid, watch.restart());
+	this->flush();
+	census.measure(census_system_t::Flush, watch.restart());
+	if (census.is_enabled() or census.is_recording()) {
+		census.capture(registry, type_index, particles);
+	}
+}
+
+void kontext_t::flush() {
+	for (auto&& deferral : change_commands) {
+		if (deferral) {
+			deferral->apply(registry);
+		}
+	}
+	if (!dispose_commands.empty()) {
+		// Destroy in one batch, skipping repeats and stale handles
+		std::sort(dispose_commands.begin(), dispose_commands.end());
+		auto last = std::unique(dispose_commands.begin(), dispose_commands.end());
+		last = std::remove_if(dispose_commands.begin(), last, [this](entt::entity actor) {
+			return !registry.valid(actor);
+		});
+		registry.destroy(dispose_commands.begin(), last);
+		dispose_commands.clear();
+	}
 	if (!spawn_commands.empty()) {
-		for (auto&& spawn : spawn_commands) {
-			this->create(spawn);
+		// Consecutive spawns of one type are built together
+		arch_t first = 0;
+		while (first < spawn_commands.size()) {
+			arch_t last = first + 1;
+			while (last < spawn_commands.size() and spawn_commands[last].type == spawn_commands[first].type) {
+				++last;
+			}
+			this->create(spawn_commands.data() + first, last - first);
+			first = last;
 		}
 		spawn_commands.clear();
 	}
@@ -61,11 +274,13 @@ void kontext_t::handle(const input_t& input, audio_t& audio, kernel_t& kernel, r
 
 void kontext_t::update(real64_t delta) {
 	sprite_t::update(*this, delta);
+	particles.update(delta);
 	blinker_t::update(*this, delta);
 }
 
 void kontext_t::render(renderer_t& renderer, const rect_t& viewport) const {
 	sprite_t::render(*this, renderer, viewport /*, panic_draw*/);
+	particles.render(renderer, viewport);
 	liquid::render(*this, renderer, viewport);
 #ifdef LEVIATHAN_USES_META
 	if (meta_state_t::Hitboxes) {
@@ -76,25 +291,42 @@ void kontext_t::render(renderer_t& renderer, const rect_t& viewport) const {
 }
 
 entt::entity kontext_t::search_type(const entt::hashed_string& type) const {
-	const auto view = const_cast<entt::registry&>(registry).view<actor_header_t>();
-	for (auto&& actor : view) {
-		auto& header = registry.get<actor_header_t>(actor);
-		if (header.type == type) {
-			return actor;
+	entt::entity result = entt::null;
+	auto iter = type_index.find(type.value());
+	if (iter != type_index.end()) {
+		// Same pick as walking the header view for the first match, without the walk
+		const auto view = const_cast<entt::registry&>(registry).view<actor_header_t>();
+		auto first = view.end();
+		for (auto&& actor : iter->second) {
+			if (!registry.all_of<actor_disposed_t>(actor)) {
+				auto position = view.find(actor);
+				if (result == entt::null or position < first) {
+					result = actor;
+					first = position;
+				}
+			}
 		}
 	}
-	return entt::null;
+	return result;
 }
 
 entt::entity kontext_t::search_id(sint_t identity) const {
 	if (identity > 0) {
+		entt::entity result = entt::null;
+		// Same pick as walking the trigger view for the first match
 		const auto view = const_cast<entt::registry&>(registry).view<actor_trigger_t>();
-		for (auto&& actor : view) {
-			auto& trigger = registry.get<actor_trigger_t>(actor);
-			if (trigger.identity == identity) {
-				return actor;
+		auto first = view.end();
+		auto range = identity_index.equal_range(identity);
+		for (auto iter = range.first; iter != range.second; ++iter) {
+			if (!registry.all_of<actor_disposed_t>(iter->second)) {
+				auto position = view.find(iter->second);
+				if (result == entt::null or position < first) {
+					result = iter->second;
+					first = position;
+				}
 			}
 		}
+		return result;
 	}
 	return entt::null;
 }
@@ -118,9 +350,13 @@ void kontext_t::kill_id(sint_t identity) {
 
 static const byte_t kMapActor[] = "actor";
 static const byte_t kMapWater[] = "water";
+static constexpr real_t kActivationMargin = 160.0f;
 
 bool kontext_t::create(const std::string& name, const glm::vec2& position, direction_t direction, sint_t identity, arch_t flags) {
-	const entt::hashed_string type{name.c_str()};
+	const entt::hashed_string type = this->intern(name);
+	if (particles.emit(type, position, glm::zero<glm::vec2>(), direction)) {
+		return true;
+	}
 	auto iter = ctor_table.find(type.value());
 	if (iter != ctor_table.end()) {
 		entt::entity actor = registry.create();
@@ -137,6 +373,51 @@ bool kontext_t::create(const std::string& name, const glm::vec2& position, direc
 }
 
 bool kontext_t::create(const actor_spawn_t& spawn) {
+	if (particles.emit(spawn.type, spawn.position, spawn.velocity, spawn.direction)) {
+		return true;
+	}
+	return this->construct(spawn) != entt::null;
+}
+
+bool kontext_t::create(const actor_spawn_t* spawns, arch_t count) {
+	if (count == 1) {
+		return this->create(spawns[0]);
+	}
+	const entt::hashed_string& type = spawns[0].type;
+	if (particle_engine_t::kind(type) != particle_kind_t::Total) {
+		for (arch_t it = 0; it < count; ++it) {
+			particles.emit(type, spawns[it].position, spawns[it].velocity, spawns[it].direction);
+		}
+		return true;
+	}
+	auto iter = ctor_table.find(type.value());
+	if (iter == ctor_table.end()) {
+		synao_log("Couldn't spawn actor {}!\n", type.data());
+		return false;
+	}
+	// One lookup and one bulk allocation for the whole burst
+	spawn_actors.resize(count);
+	spawn_locations.clear();
+	for (arch_t it = 0; it < count; ++it) {
+		spawn_locations.emplace_back(spawns[it].position, spawns[it].direction);
+	}
+	registry.create(spawn_actors.begin(), spawn_actors.end());
+	registry.insert<actor_header_t>(spawn_actors.begin(), spawn_actors.end(), actor_header_t(type));
+	registry.insert<location_t>(spawn_actors.begin(), spawn_actors.end(), spawn_locations.begin(), spawn_locations.end());
+	for (arch_t it = 0; it < count; ++it) {
+		const entt::entity actor = spawn_actors[it];
+		if (spawns[it].velocity != glm::zero<glm::vec2>()) {
+			registry.emplace<kinematics_t>(actor, spawns[it].velocity);
+		}
+		if (spawns[it].identity != 0) {
+			registry.emplace<actor_trigger_t>(actor, spawns[it].identity, spawns[it].bitmask);
+		}
+		iter->second(actor, *this);
+	}
+	return true;
+}
+
+entt::entity kontext_t::construct(const actor_spawn_t& spawn) {
 	auto iter = ctor_table.find(spawn.type.value());
 	if (iter != ctor_table.end()) {
 		entt::entity actor = registry.create();
@@ -149,14 +430,14 @@ bool kontext_t::create(const actor_spawn_t& spawn) {
 			registry.emplace<actor_trigger_t>(actor, spawn.identity, spawn.bitmask);
 		}
 		iter->second(actor, *this);
-		return true;
+		return actor;
 	}
 	synao_log("Couldn't spawn actor {}!\n", spawn.type.data());
-	return false;
+	return entt::null;
 }
 
 bool kontext_t::create_minimally(const std::string& name, real_t x, real_t y, sint_t identity) {
-	entt::hashed_string type{name.c_str()};
+	const entt::hashed_string type = this->intern(name);
 	auto iter = ctor_table.find(type.value());
 	if (iter != ctor_table.end()) {
 		spawn_commands.emplace_back(type, glm::vec2(x, y), direction_t::Right, identity, (arch_t)0);
@@ -183,7 +464,15 @@ void kontext_t::setup_layer(const std::unique_ptr<tmx::Layer>& layer, const kern
 			);
 			if (kernel.get_flag(deterrent) == (flags & (1 << actor_trigger_t::Deterred))) {
 				glm::vec2 position = ftcv::vec_to_vec(object.getPosition());
-				if (this->create(name, position, direction, identity, flags)) {
+				if (identity == 0 and !(flags & (1 << actor_trigger_t::AlwaysActive))) {
+					// Built the first time its spawn point enters the activation region
+					const entt::hashed_string type = this->intern(name);
+					if (ctor_table.find(type.value()) != ctor_table.end()) {
+						placed_spawns.emplace_back(type, position, direction);
+					} else {
+						synao_log("Couldn't create actor \"{}\"!\n", name);
+					}
+				} else if (this->create(name, position, direction, identity, flags)) {
 					if (identity != 0) {
 						auto& field = kernel.get_field();
 						receiver.push_from_symbol(identity, field, symbol);
@@ -195,27 +484,68 @@ void kontext_t::setup_layer(const std::unique_ptr<tmx::Layer>& layer, const kern
 			entt::entity actor = registry.create();
 			registry.emplace<actor_header_t>(actor);
 			registry.emplace<liquid_body_t>(actor, hitbox);
+			volumes.insert(actor, liquid::volume, hitbox);
 		}
 	}
+	volumes.bake();
 }
 
-void kontext_t::smoke(const glm::vec2& position, arch_t count) {
-	while (count > 0) {
-		this->spawn(ai::smoke::type, position);
-		--count;
+void kontext_t::activate(const camera_t& camera) {
+	const rect_t viewport = camera.get_viewport();
+	const rect_t region {
+		viewport.x - kActivationMargin,
+		viewport.y - kActivationMargin,
+		viewport.w + kActivationMargin * 2.0f,
+		viewport.h + kActivationMargin * 2.0f
+	};
+	if (!placed_spawns.empty()) {
+		auto last = std::remove_if(placed_spawns.begin(), placed_spawns.end(), [this, &region](const actor_spawn_t& spawn) {
+			if (!region.contains(spawn.position)) {
+				return false;
+			}
+			entt::entity actor = this->construct(spawn);
+			if (actor != entt::null) {
+				registry.emplace<actor_regional_t>(actor);
+			}
+			return true;
+		});
+		placed_spawns.erase(last, placed_spawns.end());
+	}
+	auto view = registry.view<actor_regional_t, location_t>();
+	for (auto&& actor : view) {
+		const bool_t inside = region.overlaps(view.get<location_t>(actor).hitbox());
+		const bool_t dormant = registry.all_of<actor_dormant_t>(actor);
+		if (inside and dormant) {
+			registry.remove<actor_dormant_t>(actor);
+		} else if (!inside and !dormant) {
+			registry.emplace<actor_dormant_t>(actor);
+		}
 	}
 }
 
+void kontext_t::smoke(const glm::vec2& position, arch_t count) {
+	particles.emit(
+		particle_kind_t::Smoke,
+		position,
+		glm::zero<glm::vec2>(),
+		direction_t::Right,
+		count
+	);
+}
+
 void kontext_t::smoke(real_t x, real_t y, arch_t count) {
 	const glm::vec2 position { x, y };
 	this->smoke(position, count);
 }
 
 void kontext_t::shrapnel(const glm::vec2& position, arch_t count) {
-	while (count > 0) {
-		this->spawn(ai::shrapnel::type, position);
-		--count;
-	}
+	particles.emit(
+		particle_kind_t::Shrapnel,
+		position,
+		glm::zero<glm::vec2>(),
+		direction_t::Right,
+		count
+	);
 }
 
 void kontext_t::shrapnel(real_t x, real_t y, arch_t count) {
@@ -258,9 +588,107 @@ void kontext_t::set_state(sint_t identity, arch_t state) {
 void kontext_t::set_mask(sint_t identity, arch_t index, bool value) {
 	entt::entity actor = this->search_id(identity);
 	if (actor != entt::null) {
-		auto& trigger = registry.get<actor_trigger_t>(actor);
-		trigger.bitmask[index] = value;
+		if (index < actor_trigger_t::TotalFlags) {
+			auto& trigger = registry.get<actor_trigger_t>(actor);
+			trigger.set(index, value);
+		}
+	}
+}
+
+void kontext_t::report() {
+	census.capture(registry, type_index, particles);
+	synao_log("Component footprint:\n");
+	for (auto&& pool : census.get_pools()) {
+		synao_log("\t{}: {} of {} slots, {} bytes\n", pool.name, pool.size, pool.capacity, pool.bytes);
+	}
+}
+
+void kontext_t::write(snapshot_writer_t& writer) const {
+	kontext_output_t archive { writer, *this };
+	entt::snapshot { registry }
+		.entities(archive)
+		.component<
+			actor_header_t, actor_trigger_t, actor_timer_t, actor_regional_t, actor_dormant_t,
+			location_t, kinematics_t, kinematics_discrete_t, kinematics_tether_t,
+			sprite_t, sprite_rotation_t, health_t, routine_t, blinker_t,
+			liquid_listener_t, liquid_body_t
+		>(archive);
+	particles.write(writer);
+	writer.value<uint64_t>(placed_spawns.size());
+	for (auto&& spawn : placed_spawns) {
+		writer.name(spawn.type);
+		writer.value(spawn.position);
+		writer.value(spawn.velocity);
+		writer.value(spawn.direction);
+		writer.value(spawn.identity);
+		writer.value<uint64_t>(spawn.bitmask.to_ullong());
+	}
+}
+
+bool kontext_t::read(snapshot_reader_t& reader) {
+	// Signals rebuild the type and identity indices as the pools refill
+	registry.clear();
+	type_index.clear();
+	type_positions.clear();
+	identity_index.clear();
+	spawn_commands.clear();
+	dispose_commands.clear();
+	for (auto&& deferral : change_commands) {
+		if (deferral) {
+			deferral->clear();
+		}
+	}
+	placed_spawns.clear();
+	broadphase.reset();
+	volumes.reset();
+	particles.reset();
+
+	kontext_input_t archive { reader, *this };
+	entt::snapshot_loader { registry }
+		.entities(archive)
+		.component<
+			actor_header_t, actor_trigger_t, actor_timer_t, actor_regional_t, actor_dormant_t,
+			location_t, kinematics_t, kinematics_discrete_t, kinematics_tether_t,
+			sprite_t, sprite_rotation_t, health_t, routine_t, blinker_t,
+			liquid_listener_t, liquid_body_t
+		>(archive)
+		.orphans();
+	if (archive.broken) {
+		synao_log("Kontext snapshot came from another build!\n");
+		return false;
+	}
+	if (!particles.read(reader)) {
+		synao_log("Particle snapshot is broken!\n");
+		return false;
+	}
+	uint64_t count = 0;
+	reader.value(count);
+	for (uint64_t it = 0; it < count and reader.valid(); ++it) {
+		const std::string* name = nullptr;
+		actor_spawn_t spawn {};
+		uint64_t literal_bitmask = 0;
+		reader.name(name);
+		reader.value(spawn.position);
+		reader.value(spawn.velocity);
+		reader.value(spawn.direction);
+		reader.value(spawn.identity);
+		reader.value(literal_bitmask);
+		if (name) {
+			spawn.type = this->intern(*name);
+		}
+		spawn.bitmask = std::bitset<actor_trigger_t::TotalFlags>(literal_bitmask);
+		placed_spawns.push_back(spawn);
+	}
+	if (!reader.valid()) {
+		synao_log("Kontext snapshot is broken!\n");
+		return false;
+	}
+	auto bodies = registry.view<liquid_body_t>();
+	for (auto&& actor : bodies) {
+		volumes.insert(actor, liquid::volume, bodies.get<liquid_body_t>(actor).hitbox);
 	}
+	volumes.bake();
+	return true;
 }
 
 void kontext_t::set_event(sint_t identity, asIScriptFunction* function) {
@@ -276,9 +704,9 @@ void kontext_t::set_fight(sint_t identity, asIScriptFunction* function) {
 	entt::entity actor = this->search_id(identity);
 	if (actor != entt::null) {
 		auto& trigger = this->get<actor_trigger_t>(actor);
-		trigger.bitmask[actor_trigger_t::Hostile] = true;
-		trigger.bitmask[actor_trigger_t::InteractionEvent] = false;
-		trigger.bitmask[actor_trigger_t::DeathEvent] = true;
+		trigger.set(actor_trigger_t::Hostile, true);
+		trigger.set(actor_trigger_t::InteractionEvent, false);
+		trigger.set(actor_trigger_t::DeathEvent, true);
 
 		auto& health = this->assign_if<health_t>(actor);
 		health.reset();
@@ -306,3 +734,255 @@ bool kontext_t::still(sint_t identity) const {
 	}
 	return true;
 }
+
+bool kontext_t::create_minimally_n(const std::string& name, const CScriptArray* x, const CScriptArray* y, const CScriptArray* identities) {
+	if (!x or !y or x->GetSize() != y->GetSize()) {
+		synao_log("Spawning {} failed because coordinate arrays don't match!\n", name);
+		return false;
+	}
+	const entt::hashed_string type = this->intern(name);
+	if (ctor_table.find(type.value()) == ctor_table.end()) {
+		return false;
+	}
+	const arch_t count = static_cast<arch_t>(x->GetSize());
+	const arch_t named = identities ? static_cast<arch_t>(identities->GetSize()) : 0;
+	spawn_commands.reserve(spawn_commands.size() + count);
+	for (arch_t it = 0; it < count; ++it) {
+		const glm::vec2 position {
+			*static_cast<const real_t*>(x->At(static_cast<asUINT>(it))),
+			*static_cast<const real_t*>(y->At(static_cast<asUINT>(it)))
+		};
+		const sint_t identity = it < named ?
+			*static_cast<const sint_t*>(identities->At(static_cast<asUINT>(it))) :
+			0;
+		spawn_commands.emplace_back(type, position, direction_t::Right, identity, (arch_t)0);
+	}
+	return true;
+}
+
+void kontext_t::destroy_n(const CScriptArray* identities) {
+	for (auto&& actor : this->select(identities)) {
+		this->dispose(actor);
+	}
+}
+
+void kontext_t::destroy_all(const std::string& type) {
+	for (auto&& actor : this->select(type)) {
+		this->dispose(actor);
+	}
+}
+
+void kontext_t::kill_n(const CScriptArray* identities) {
+	for (auto&& actor : this->select(identities)) {
+		if (registry.all_of<health_t>(actor)) {
+			auto& health = registry.get<health_t>(actor);
+			health.current = 0;
+		}
+	}
+}
+
+void kontext_t::bump_n(const CScriptArray* identities, real_t velocity_x, real_t velocity_y) {
+	this->select(identities);
+	this->bump_selection(glm::vec2(velocity_x, velocity_y));
+}
+
+void kontext_t::bump_all(const std::string& type, real_t velocity_x, real_t velocity_y) {
+	this->select(type);
+	this->bump_selection(glm::vec2(velocity_x, velocity_y));
+}
+
+void kontext_t::animate_n(const CScriptArray* identities, arch_t state, arch_t variation) {
+	this->select(identities);
+	this->animate_selection(state, variation);
+}
+
+void kontext_t::animate_all(const std::string& type, arch_t state, arch_t variation) {
+	this->select(type);
+	this->animate_selection(state, variation);
+}
+
+void kontext_t::set_state_n(const CScriptArray* identities, arch_t state) {
+	this->select(identities);
+	this->set_state_selection(state);
+}
+
+void kontext_t::set_state_all(const std::string& type, arch_t state) {
+	this->select(type);
+	this->set_state_selection(state);
+}
+
+bool kontext_t::still_n(const CScriptArray* identities) const {
+	if (identities) {
+		for (asUINT it = 0; it < identities->GetSize(); ++it) {
+			if (!this->still(*static_cast<const sint_t*>(identities->At(it)))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+entt::id_type kontext_t::routine_name(routine_tick_fn tick) const {
+	if (!tick) {
+		return 0;
+	}
+	auto iter = tick_names.find(tick);
+	if (iter != tick_names.end()) {
+		return iter->second;
+	}
+	synao_log("Warning! Routine tick isn't in the tick table and won't restore!\n");
+	return kUnnamedTick;
+}
+
+routine_tick_fn kontext_t::routine_tick(entt::id_type name) const {
+	auto iter = tick_table.find(name);
+	if (iter != tick_table.end()) {
+		return iter->second;
+	}
+	return nullptr;
+}
+
+CScriptArray* kontext_t::identities(const std::string& type) const {
+	std::vector<sint_t> result;
+	auto iter = type_index.find(entt::hashed_string{type.c_str()}.value());
+	if (iter != type_index.end()) {
+		for (auto&& actor : iter->second) {
+			// Actors spawned without an identity never get a trigger
+			const auto trigger = registry.try_get<actor_trigger_t>(actor);
+			if (trigger and trigger->identity > 0) {
+				result.push_back(trigger->identity);
+			}
+		}
+	}
+	// The index's order depends on insertion history, so sort to keep scripts deterministic
+	std::sort(result.begin(), result.end());
+	CScriptArray* array = make_array(kIdentityArray, result.size());
+	if (array) {
+		for (arch_t it = 0; it < result.size(); ++it) {
+			*static_cast<sint_t*>(array->At(static_cast<asUINT>(it))) = result[it];
+		}
+	}
+	return array;
+}
+
+CScriptArray* kontext_t::positions(const CScriptArray* identities) const {
+	const arch_t count = identities ? static_cast<arch_t>(identities->GetSize()) : 0;
+	// Coordinates are interleaved, and missing actors read as the origin
+	CScriptArray* array = make_array(kPositionArray, count * 2);
+	if (array) {
+		for (arch_t it = 0; it < count; ++it) {
+			glm::vec2 position {};
+			entt::entity actor = this->search_id(*static_cast<const sint_t*>(identities->At(static_cast<asUINT>(it))));
+			if (actor != entt::null and registry.all_of<location_t>(actor)) {
+				position = registry.get<location_t>(actor).position;
+			}
+			*static_cast<real_t*>(array->At(static_cast<asUINT>(it * 2))) = position.x;
+			*static_cast<real_t*>(array->At(static_cast<asUINT>(it * 2 + 1))) = position.y;
+		}
+	}
+	return array;
+}
+
+entt::hashed_string kontext_t::intern(const std::string& name) {
+	// Headers keep a pointer to their name, so names read from maps or
+	// scripts are stored here for as long as the kontext lives
+	const entt::hashed_string type{name.c_str()};
+	auto iter = type_names.find(type.value());
+	if (iter == type_names.end()) {
+		iter = type_names.emplace(type.value(), name).first;
+	}
+	return entt::hashed_string{iter->second.c_str()};
+}
+
+const std::vector<entt::entity>& kontext_t::select(const CScriptArray* identities) {
+	selection.clear();
+	if (identities) {
+		for (asUINT it = 0; it < identities->GetSize(); ++it) {
+			const sint_t identity = *static_cast<const sint_t*>(identities->At(it));
+			if (identity > 0) {
+				auto range = identity_index.equal_range(identity);
+				for (auto iter = range.first; iter != range.second; ++iter) {
+					selection.push_back(iter->second);
+				}
+			}
+		}
+	}
+	return selection;
+}
+
+const std::vector<entt::entity>& kontext_t::select(const std::string& type) {
+	selection.clear();
+	auto iter = type_index.find(entt::hashed_string{type.c_str()}.value());
+	if (iter != type_index.end()) {
+		selection.assign(iter->second.begin(), iter->second.end());
+	}
+	return selection;
+}
+
+void kontext_t::bump_selection(const glm::vec2& velocity) {
+	for (auto&& actor : selection) {
+		if (registry.all_of<kinematics_t>(actor)) {
+			auto& kinematics = registry.get<kinematics_t>(actor);
+			kinematics.velocity = velocity;
+		}
+	}
+}
+
+void kontext_t::animate_selection(arch_t state, arch_t variation) {
+	for (auto&& actor : selection) {
+		if (registry.all_of<sprite_t>(actor)) {
+			auto& sprite = registry.get<sprite_t>(actor);
+			sprite.variation = variation;
+			sprite.new_state(state);
+		}
+	}
+}
+
+void kontext_t::set_state_selection(arch_t state) {
+	for (auto&& actor : selection) {
+		if (registry.all_of<routine_t>(actor)) {
+			auto& routine = registry.get<routine_t>(actor);
+			routine.state = state;
+		}
+	}
+}
+
+void kontext_t::attach_type(entt::registry&, entt::entity actor) {
+	const auto& header = registry.get<actor_header_t>(actor);
+	auto& actors = type_index[header.type.value()];
+	type_positions[actor] = actors.size();
+	actors.push_back(actor);
+	census.spawned();
+}
+
+void kontext_t::detach_type(entt::registry&, entt::entity actor) {
+	census.destroyed();
+	const auto& header = registry.get<actor_header_t>(actor);
+	auto iter = type_index.find(header.type.value());
+	auto position = type_positions.find(actor);
+	if (iter != type_index.end() and position != type_positions.end()) {
+		// Swap the last actor of this type into the gap
+		auto& actors = iter->second;
+		const entt::entity moved = actors.back();
+		actors[position->second] = moved;
+		type_positions[moved] = position->second;
+		actors.pop_back();
+		type_positions.erase(actor);
+	}
+}
+
+void kontext_t::attach_identity(entt::registry&, entt::entity actor) {
+	const auto& trigger = registry.get<actor_trigger_t>(actor);
+	identity_index.emplace(trigger.identity, actor);
+}
+
+void kontext_t::detach_identity(entt::registry&, entt::entity actor) {
+	const auto& trigger = registry.get<actor_trigger_t>(actor);
+	auto range = identity_index.equal_range(trigger.identity);
+	for (auto iter = range.first; iter != range.second; ++iter) {
+		if (iter->second == actor) {
+			identity_index.erase(iter);
+			break;
+		}
+	}
+}
@@ -8,11 +8,19 @@
 #include <tmxlite/Layer.hpp>
 
 #include "./common.hpp"
+#include "./deferral.hpp"
+#include "./broadphase.hpp"
+#include "./census.hpp"
+#include "./particle-engine.hpp"
+#include "./volumes.hpp"
+#include "./location.hpp"
+#include "./kinematics.hpp"
 #include "./routine.hpp"
 #include "./sprite.hpp"
 #include "../utility/rect.hpp"
 
 class asIScriptFunction;
+class CScriptArray;
 
 struct input_t;
 struct audio_t;
@@ -23,6 +31,8 @@ struct headsup_gui_t;
 struct camera_t;
 struct naomi_state_t;
 struct tilemap_t;
+struct snapshot_writer_t;
+struct snapshot_reader_t;
 
 struct kontext_t : public not_copyable_t {
 public:
@@ -33,7 +43,7 @@ public:
 public:
 	bool init(receiver_t& receiver, headsup_gui_t& headsup_gui);
 	void reset();
-	void handle(const input_t& input, audio_t& audio, kernel_t& kernel, receiver_t& receiver, headsup_gui_t& headsup_gui, camera_t& camera, naomi_state_t& naomi_state, const tilemap_t& tilemap);
+	void handle(const input_t& input, audio_t& audio, kernel_t& kernel, receiver_t& receiver, headsup_gui_t& headsup_gui, camera_t& camera, naomi_state_t& naomi_state, tilemap_t& tilemap);
 	void update(real64_t delta);
 	void render(renderer_t& renderer, const rect_t& viewport) const;
 	entt::entity search_type(const entt::hashed_string& type) const;
@@ -44,6 +54,7 @@ public:
 	bool create(const std::string& name, const glm::vec2& position, direction_t direction, sint_t identity, arch_t flags);
 	bool create_minimally(const std::string& name, real_t x, real_t y, sint_t identity);
 	void setup_layer(const std::unique_ptr<tmx::Layer>& layer, const kernel_t& kernel, receiver_t& receiver);
+	void activate(const camera_t& camera);
 	void smoke(const glm::vec2& position, arch_t count);
 	void smoke(real_t x, real_t y, arch_t count);
 	void shrapnel(const glm::vec2& position, arch_t count);
@@ -55,22 +66,59 @@ public:
 	void set_event(sint_t identity, asIScriptFunction* function);
 	void set_fight(sint_t identity, asIScriptFunction* function);
 	bool still(sint_t identity) const;
+	bool create_minimally_n(const std::string& name, const CScriptArray* x, const CScriptArray* y, const CScriptArray* identities);
+	void destroy_n(const CScriptArray* identities);
+	void destroy_all(const std::string& type);
+	void kill_n(const CScriptArray* identities);
+	void bump_n(const CScriptArray* identities, real_t velocity_x, real_t velocity_y);
+	void bump_all(const std::string& type, real_t velocity_x, real_t velocity_y);
+	void animate_n(const CScriptArray* identities, arch_t state, arch_t variation);
+	void animate_all(const std::string& type, arch_t state, arch_t variation);
+	void set_state_n(const CScriptArray* identities, arch_t state);
+	void set_state_all(const std::string& type, arch_t state);
+	bool still_n(const CScriptArray* identities) const;
+	CScriptArray* identities(const std::string& type) const;
+	CScriptArray* positions(const CScriptArray* identities) const;
 	void run(const actor_trigger_t& trigger) const;
 	void meter(sint_t current, sint_t maximum) const;
+	void report();
+	void write(snapshot_writer_t& writer) const;
+	bool read(snapshot_reader_t& reader);
+	entt::hashed_string intern(const std::string& name);
 	template<typename... Args>
 	bool spawn(const entt::hashed_string& type, Args&& ...args);
 	bool spawn(const actor_spawn_t& spawn);
+	bool spawn_n(const entt::hashed_string& type, const glm::vec2* positions, arch_t count, direction_t direction);
+	bool spawn_n(const entt::hashed_string& type, const std::vector<glm::vec2>& positions, direction_t direction);
 	void dispose(entt::entity actor);
+	template<typename Component, typename ...Args>
+	void defer_emplace(entt::entity actor, Args&& ...args);
+	template<typename Component>
+	void defer_remove(entt::entity actor);
+	void flush();
 	bool valid(entt::entity actor) const;
+	bool alive(entt::entity actor) const;
 	arch_t size() const;
 	arch_t active() const;
 	entt::registry* backend();
+	broadphase_t& get_broadphase();
+	const broadphase_t& get_broadphase() const;
+	const volume_index_t& get_volumes() const;
+	const particle_engine_t& get_particles() const;
+	census_t& get_census();
+	const census_t& get_census() const;
+	std::vector<entt::entity>& get_tick_group();
 	entt::basic_view<entt::entity, entt::exclude_t<>, actor_header_t> actors();
+	entt::basic_group<entt::entity, entt::exclude_t<actor_dormant_t>, entt::get_t<>, kinematics_t, location_t> bodies();
 	template<typename... Component>
 	entt::basic_view<entt::entity, entt::exclude_t<>, Component...> slice();
 	template<typename... Component>
 	entt::basic_view<entt::entity, entt::exclude_t<>, Component...> slice() const;
 	template<typename... Component>
+	entt::basic_view<entt::entity, entt::exclude_t<actor_dormant_t, actor_disposed_t>, Component...> awake();
+	template<typename... Component>
+	entt::basic_view<entt::entity, entt::exclude_t<actor_disposed_t>, Component...> present() const;
+	template<typename... Component>
 	bool has(entt::entity actor) const;
 	template<typename... Component>
 	decltype(auto) get(entt::entity actor);
@@ -82,11 +130,49 @@ public:
 	decltype(auto) assign_if(entt::entity actor, Args&& ...args);
 	template<typename Component, typename Compare, typename... Args>
 	void sort(Compare compare, Args&& ...args);
+	template<typename Component, typename Compare>
+	void resort(Compare compare);
+	routine_batch_fn batch(routine_tick_fn tick) const;
+	entt::id_type routine_name(routine_tick_fn tick) const;
+	entt::id_type routine_order(routine_tick_fn tick) const;
+	routine_tick_fn routine_tick(entt::id_type name) const;
+private:
+	bool create(const actor_spawn_t* spawns, arch_t count);
+	entt::entity construct(const actor_spawn_t& spawn);
+	void attach_type(entt::registry&, entt::entity actor);
+	void detach_type(entt::registry&, entt::entity actor);
+	void attach_identity(entt::registry&, entt::entity actor);
+	void detach_identity(entt::registry&, entt::entity actor);
+	const std::vector<entt::entity>& select(const CScriptArray* identities);
+	const std::vector<entt::entity>& select(const std::string& type);
+	void bump_selection(const glm::vec2& velocity);
+	void animate_selection(arch_t state, arch_t variation);
+	void set_state_selection(arch_t state);
+	template<typename Component>
+	deferral_t<Component>& deferral();
 private:
 	// mutable bool_t panic_draw { false };
 	entt::registry registry {};
+	broadphase_t broadphase {};
+	volume_index_t volumes {};
+	particle_engine_t particles {};
+	census_t census {};
+	std::unordered_map<entt::id_type, std::vector<entt::entity> > type_index {};
+	std::unordered_map<entt::entity, arch_t> type_positions {};
+	std::unordered_multimap<sint_t, entt::entity> identity_index {};
+	std::unordered_map<entt::id_type, std::string> type_names {};
 	std::vector<actor_spawn_t> spawn_commands {};
+	std::vector<entt::entity> spawn_actors {};
+	std::vector<location_t> spawn_locations {};
+	std::vector<actor_spawn_t> placed_spawns {};
+	std::vector<entt::entity> dispose_commands {};
+	std::vector<std::unique_ptr<deferral_i> > change_commands {};
+	std::vector<entt::entity> selection {};
+	std::vector<entt::entity> tick_group {};
 	std::unordered_map<entt::id_type, routine_ctor_fn> ctor_table {};
+	std::unordered_map<routine_tick_fn, routine_batch_fn> batch_table {};
+	std::unordered_map<entt::id_type, routine_tick_fn> tick_table {};
+	std::unordered_map<routine_tick_fn, entt::id_type> tick_names {};
 	std::function<void(sint_t)> run_event {};
 	std::function<void(sint_t, asIScriptFunction*)> push_event {};
 	std::function<void(sint_t, sint_t)> push_meter {};
@@ -111,17 +197,65 @@ inline bool kontext_t::spawn(const actor_spawn_t& spawn) {
 	return true;
 }
 
+inline bool kontext_t::spawn_n(const entt::hashed_string& type, const glm::vec2* positions, arch_t count, direction_t direction) {
+	spawn_commands.reserve(spawn_commands.size() + count);
+	for (arch_t it = 0; it < count; ++it) {
+		spawn_commands.emplace_back(type, positions[it], direction);
+	}
+	return true;
+}
+
+inline bool kontext_t::spawn_n(const entt::hashed_string& type, const std::vector<glm::vec2>& positions, direction_t direction) {
+	return this->spawn_n(type, positions.data(), positions.size(), direction);
+}
+
 inline void kontext_t::dispose(entt::entity actor) {
 	// if (!panic_draw) {
 	// 	panic_draw = registry.all_of<sprite_t>(actor);
 	// }
-	registry.destroy(actor);
+	// Destroyed at the next flush, so views stay intact while iterating.
+	// Until then it's tagged, and tags live in their own pool, so marking
+	// never moves the components of anything being iterated
+	if (registry.valid(actor)) {
+		registry.emplace_or_replace<actor_disposed_t>(actor);
+	}
+	dispose_commands.push_back(actor);
+}
+
+template<typename Component, typename ...Args>
+inline void kontext_t::defer_emplace(entt::entity actor, Args&& ...args) {
+	this->deferral<Component>().emplace(actor, std::forward<Args>(args)...);
+}
+
+template<typename Component>
+inline void kontext_t::defer_remove(entt::entity actor) {
+	this->deferral<Component>().remove(actor);
+}
+
+template<typename Component>
+inline deferral_t<Component>& kontext_t::deferral() {
+	// Each component type gets one queue the first time it's deferred
+	const arch_t index = deferral_t<Component>::index();
+	if (index >= change_commands.size()) {
+		change_commands.resize(index + 1);
+	}
+	if (!change_commands[index]) {
+		change_commands[index] = std::make_unique<deferral_t<Component> >();
+	}
+	return static_cast<deferral_t<Component>&>(*change_commands[index]);
 }
 
 inline bool kontext_t::valid(entt::entity actor) const {
 	return registry.valid(actor);
 }
 
+inline bool kontext_t::alive(entt::entity actor) const {
+	if (!registry.valid(actor)) {
+		return false;
+	}
+	return !registry.all_of<actor_disposed_t>(actor);
+}
+
 inline arch_t kontext_t::size() const {
 	return registry.size();
 }
@@ -134,6 +268,38 @@ inline entt::registry* kontext_t::backend() {
 	return &registry;
 }
 
+inline broadphase_t& kontext_t::get_broadphase() {
+	return broadphase;
+}
+
+inline const broadphase_t& kontext_t::get_broadphase() const {
+	return broadphase;
+}
+
+inline const volume_index_t& kontext_t::get_volumes() const {
+	return volumes;
+}
+
+inline const particle_engine_t& kontext_t::get_particles() const {
+	return particles;
+}
+
+inline census_t& kontext_t::get_census() {
+	return census;
+}
+
+inline const census_t& kontext_t::get_census() const {
+	return census;
+}
+
+inline std::vector<entt::entity>& kontext_t::get_tick_group() {
+	return tick_group;
+}
+
+inline entt::basic_group<entt::entity, entt::exclude_t<actor_dormant_t>, entt::get_t<>, kinematics_t, location_t> kontext_t::bodies() {
+	return registry.group<kinematics_t, location_t>(entt::exclude<actor_dormant_t>);
+}
+
 inline entt::basic_view<entt::entity, entt::exclude_t<>, actor_header_t> kontext_t::actors() {
 	return this->slice<actor_header_t>();
 }
@@ -148,6 +314,16 @@ inline entt::basic_view<entt::entity, entt::exclude_t<>, Component...> kontext_t
 	return const_cast<entt::registry&>(registry).view<Component...>();
 }
 
+template<typename... Component>
+inline entt::basic_view<entt::entity, entt::exclude_t<actor_dormant_t, actor_disposed_t>, Component...> kontext_t::awake() {
+	return registry.view<Component...>(entt::exclude<actor_dormant_t, actor_disposed_t>);
+}
+
+template<typename... Component>
+inline entt::basic_view<entt::entity, entt::exclude_t<actor_disposed_t>, Component...> kontext_t::present() const {
+	return const_cast<entt::registry&>(registry).view<Component...>(entt::exclude<actor_disposed_t>);
+}
+
 template<typename... Component>
 inline bool kontext_t::has(entt::entity actor) const {
 	return registry.all_of<Component...>(actor);
@@ -177,3 +353,25 @@ template<typename Component, typename Compare, typename... Args>
 inline void kontext_t::sort(Compare compare, Args&& ...args) {
 	registry.sort<Component>(compare, entt::std_sort{}, std::forward<Args>(args)...);
 }
+
+template<typename Component, typename Compare>
+inline void kontext_t::resort(Compare compare) {
+	// Insertion sort is close to linear when the pool is already nearly ordered
+	registry.sort<Component>(compare, entt::insertion_sort{});
+}
+
+inline entt::id_type kontext_t::routine_order(routine_tick_fn tick) const {
+	auto iter = tick_names.find(tick);
+	if (iter != tick_names.end()) {
+		return iter->second;
+	}
+	return 0;
+}
+
+inline routine_batch_fn kontext_t::batch(routine_tick_fn tick) const {
+	auto iter = batch_table.find(tick);
+	if (iter != batch_table.end()) {
+		return iter->second;
+	}
+	return nullptr;
+}
@@ -6,8 +6,10 @@
 #include "../system/renderer.hpp"
 
 void liquid::handle(audio_t& audio, kontext_t& kontext, const location_t& location, liquid_listener_t& listener) {
-	auto checker = [&location, &listener](entt::entity liquid, const liquid_body_t& body) {
-		if (listener.liquid == entt::null and location.overlap(body.hitbox)) {
+	const rect_t hitbox = location.hitbox();
+	auto& volumes = kontext.get_volumes();
+	auto checker = [&kontext, &listener](entt::entity liquid, const rect_t&) {
+		if (listener.liquid == entt::null and kontext.valid(liquid)) {
 			listener.liquid = liquid;
 		}
 	};
@@ -24,8 +26,9 @@ void liquid::handle(audio_t& audio, kontext_t& kontext, const location_t& locati
 
 	};
 	if (listener.liquid == entt::null or !kontext.valid(listener.liquid)) {
+		// Enter
 		listener.liquid = entt::null;
-		kontext.slice<liquid_body_t>().each(checker);
+		volumes.query(liquid::volume, hitbox, checker);
 		if (listener.liquid != entt::null) {
 			std::invoke(
 				spawner,
@@ -34,10 +37,11 @@ void liquid::handle(audio_t& audio, kontext_t& kontext, const location_t& locati
 				kontext.get<liquid_body_t>(listener.liquid).hitbox
 			);
 		}
-	} else if (!location.overlap(kontext.get<liquid_body_t>(listener.liquid).hitbox)) {
+	} else if (!hitbox.overlaps(kontext.get<liquid_body_t>(listener.liquid).hitbox)) {
+		// Exit, unless an adjacent body was entered at the same time
 		rect_t copy_box = kontext.get<liquid_body_t>(listener.liquid).hitbox;
 		listener.liquid = entt::null;
-		kontext.slice<liquid_body_t>().each(checker);
+		volumes.query(liquid::volume, hitbox, checker);
 		if (listener.liquid == entt::null) {
 			std::invoke(spawner, location, listener, copy_box);
 		}
@@ -52,31 +56,18 @@ void liquid::handle(audio_t& audio, kontext_t& kontext) {
 
 void liquid::render(const kontext_t& kontext, renderer_t& renderer, const rect_t& viewport) {
 	const glm::vec4 water_color { 0.0f, 0.25f, 0.5f, 0.5f };
-	const auto view = kontext.slice<liquid_body_t>();
-	if (!view.empty()) {
+	auto& volumes = kontext.get_volumes();
+	if (volumes.size() > 0) {
 		auto& list = renderer.display_list(
 			layer_value::Foreground,
 			blend_mode_t::Add,
 			program_t::Colors
 		);
-		view.each([&list, &viewport, &water_color](entt::entity, const liquid_body_t& instance) {
-			// if (!instance.hitbox.overlaps(viewport)) {
-			// 	instance.amend = true;
-			// } else if (instance.amend) {
-			// 	instance.amend = false;
-			// 	list.begin(display_list_t::SingleQuad)
-			// 		.vtx_blank_write(instance.hitbox, water_color)
-			// 		.vtx_transform_write(instance.hitbox.left_top())
-			// 	.end();
-			// } else {
-			// 	list.skip(display_list_t::SingleQuad);
-			// }
-			if (instance.hitbox.overlaps(viewport)) {
-				list.begin(display_list_t::SingleQuad)
-					.vtx_blank_write(instance.hitbox, water_color)
-					.vtx_transform_write(instance.hitbox.left_top())
-				.end();
-			}
+		volumes.query(liquid::volume, viewport, [&list, &water_color](entt::entity, const rect_t& hitbox) {
+			list.begin(display_list_t::SingleQuad)
+				.vtx_blank_write(hitbox, water_color)
+				.vtx_transform_write(hitbox.left_top())
+			.end();
 		});
 	}
 }
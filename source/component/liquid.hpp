@@ -44,6 +44,7 @@ public:
 };
 
 namespace liquid {
+	constexpr entt::hashed_string volume = "water";
 	void handle(audio_t& audio, kontext_t& kontext, const location_t& location, liquid_listener_t& listener);
 	void handle(audio_t& audio, kontext_t& kontext);
 	void render(const kontext_t& context, renderer_t& renderer, const rect_t& viewport);
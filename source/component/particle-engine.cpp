@@ -0,0 +1,366 @@
+#include "./particle-engine.hpp"
+#include "./location.hpp"
+#include "./kinematics.hpp"
+
+#include "../actor/particles.hpp"
+#include "../field/tilemap.hpp"
+#include "../resource/animation.hpp"
+#include "../resource/id.hpp"
+#include "../resource/vfs.hpp"
+#include "../system/snapshot.hpp"
+#include "../utility/rng.hpp"
+
+#include <glm/common.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	struct particle_spec_t {
+	public:
+		entt::hashed_string type;
+		entt::hashed_string entry;
+		arch_t state;
+		glm::vec2 offset;
+		rect_t bounding;
+		sint_t lifetime;
+		real_t gravity;
+		real_t fade;
+		real_t friction;
+		bool_t colliding;
+	};
+
+	// Indexed by particle_kind_t
+	const particle_spec_t kSpecs[particle_kind_t::Total] = {
+		{ ai::smoke::type, 			res::anim::Smoke, 		0, { -8.0f, -8.0f }, 	{ 6.0f, 6.0f, 4.0f, 4.0f }, 35, 0.0f, 0.0f, 0.05f, true },
+		{ ai::shrapnel::type, 		res::anim::Shrapnel, 	0, { -8.0f, -8.0f }, 	{}, 25, 0.2f, 0.0f, 0.0f, false },
+		{ ai::dust::type, 			res::anim::HolyLance, 	1, { 0.0f, 0.0f }, 		{}, 50, 0.0f, 0.02f, 0.0f, false },
+		{ ai::splash::type, 		res::anim::Splash, 		0, { -8.0f, -16.0f }, 	{}, 7, 0.0f, 0.0f, 0.0f, false },
+		{ ai::blast_small::type, 	res::anim::Blast, 		0, { -8.0f, -8.0f }, 	{}, 4, 0.0f, 0.0f, 0.0f, false },
+		{ ai::blast_medium::type, 	res::anim::Blast, 		1, { -16.0f, -16.0f }, 	{}, 8, 0.0f, 0.0f, 0.0f, false },
+		{ ai::blast_large::type, 	res::anim::Blast, 		2, { -24.0f, -24.0f }, 	{}, 9, 0.0f, 0.0f, 0.0f, false },
+		{ ai::energy_trail::type, 	res::anim::Kannon, 		1, { 0.0f, 0.0f }, 		{}, 7, 0.0f, 0.0f, 0.0f, false },
+		{ ai::dash_flash::type, 	res::anim::DashFlash, 	0, { -16.0f, -16.0f }, 	{}, 6, 0.0f, 0.0f, 0.0f, false }
+	};
+
+	constexpr real_t kFallLimit = 6.0f;
+	constexpr layer_t kParticleLayer = 0.6f;
+	constexpr arch_t kRandomColumns = 4;
+
+	glm::vec2 angled(real_t angle, real_t speed) {
+		return {
+			glm::cos(angle) * speed,
+			glm::sin(angle) * speed
+		};
+	}
+}
+
+void particle_bucket_t::clear() {
+	positions.clear();
+	velocities.clear();
+	flags.clear();
+	timers.clear();
+	frames.clear();
+	alphas.clear();
+	lifetimes.clear();
+}
+
+void particle_bucket_t::push(const glm::vec2& position, const glm::vec2& velocity, sint_t lifetime) {
+	positions.push_back(position);
+	velocities.push_back(velocity);
+	flags.emplace_back();
+	timers.push_back(0.0);
+	frames.push_back(0);
+	alphas.push_back(1.0f);
+	lifetimes.push_back(lifetime);
+}
+
+void particle_bucket_t::compact() {
+	const arch_t length = positions.size();
+	arch_t count = 0;
+	for (arch_t it = 0; it < length; ++it) {
+		if (lifetimes[it] >= 0 and alphas[it] > 0.0f) {
+			if (count != it) {
+				positions[count] = positions[it];
+				velocities[count] = velocities[it];
+				flags[count] = flags[it];
+				timers[count] = timers[it];
+				frames[count] = frames[it];
+				alphas[count] = alphas[it];
+				lifetimes[count] = lifetimes[it];
+			}
+			++count;
+		}
+	}
+	if (count != length) {
+		positions.resize(count);
+		velocities.resize(count);
+		flags.resize(count);
+		timers.resize(count);
+		frames.resize(count);
+		alphas.resize(count);
+		lifetimes.resize(count);
+	}
+}
+
+arch_t particle_bucket_t::size() const {
+	return positions.size();
+}
+
+arch_t particle_bucket_t::capacity() const {
+	return positions.capacity();
+}
+
+void particle_engine_t::reset() {
+	for (auto&& bucket : buckets) {
+		bucket.clear();
+	}
+	animations.fill(nullptr);
+}
+
+bool particle_engine_t::emit(const entt::hashed_string& type, const glm::vec2& position, const glm::vec2& velocity, direction_t direction) {
+	const particle_kind_t kind = particle_engine_t::kind(type);
+	if (kind != particle_kind_t::Total) {
+		this->emit(kind, position, velocity, direction, 1);
+		return true;
+	}
+	return false;
+}
+
+void particle_engine_t::emit(particle_kind_t kind, const glm::vec2& position, const glm::vec2& velocity, direction_t direction, arch_t count) {
+	if (kind >= particle_kind_t::Total or !this->animation(kind)) {
+		return;
+	}
+	const particle_spec_t& spec = kSpecs[kind];
+	auto& bucket = buckets[kind];
+	// Draw the whole burst up front, one range per column
+	randoms.resize(count * kRandomColumns);
+	real_t* columns[kRandomColumns] = {};
+	for (arch_t it = 0; it < kRandomColumns; ++it) {
+		columns[it] = randoms.data() + it * count;
+	}
+	switch (kind) {
+	case particle_kind_t::Smoke:
+		rng::fill(rng_stream_t::Particles, 0.0f, glm::two_pi<real_t>(), columns[0], count);
+		rng::fill(rng_stream_t::Particles, 0.3f, 3.0f, columns[1], count);
+		break;
+	case particle_kind_t::Shrapnel:
+		rng::fill(rng_stream_t::Particles, -3.0f, 3.0f, columns[0], count);
+		rng::fill(rng_stream_t::Particles, -3.0f, 3.0f, columns[1], count);
+		rng::fill(rng_stream_t::Particles, -2.44346f, -0.698132f, columns[2], count);
+		rng::fill(rng_stream_t::Particles, 1.0f, 6.0f, columns[3], count);
+		break;
+	case particle_kind_t::Dust:
+		rng::fill(rng_stream_t::Particles, -0.08f, 0.08f, columns[0], count);
+		rng::fill(rng_stream_t::Particles, 3.0f, 4.0f, columns[1], count);
+		rng::fill(rng_stream_t::Particles, -6.0f, 6.0f, columns[2], count);
+		break;
+	default:
+		break;
+	}
+	for (arch_t it = 0; it < count; ++it) {
+		glm::vec2 origin = position + spec.offset;
+		glm::vec2 motion = velocity;
+		switch (kind) {
+		case particle_kind_t::Smoke: {
+			motion = angled(columns[0][it], columns[1][it]);
+			break;
+		}
+		case particle_kind_t::Shrapnel: {
+			origin.x += columns[0][it];
+			origin.y += columns[1][it];
+			motion = angled(columns[2][it], columns[3][it]);
+			break;
+		}
+		case particle_kind_t::Dust: {
+			const real_t variation = columns[0][it];
+			const real_t speed = columns[1][it];
+			const real_t spread = columns[2][it];
+			if (direction & direction_t::Down) {
+				origin.x += spread;
+				origin.y += 8.0f;
+				motion = angled(glm::half_pi<real_t>() + variation, speed);
+			} else if (direction & direction_t::Up) {
+				origin.x += spread;
+				origin.y -= 8.0f;
+				motion = angled(1.5f * glm::pi<real_t>() + variation, speed);
+			} else if (direction & direction_t::Left) {
+				origin.x -= 8.0f;
+				origin.y += spread;
+				motion = angled(glm::pi<real_t>() + variation, speed);
+			} else {
+				origin.x += 8.0f;
+				origin.y += spread;
+				motion = angled(variation, speed);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+		bucket.push(origin, motion, spec.lifetime);
+	}
+}
+
+void particle_engine_t::handle(const tilemap_t& tilemap) {
+	for (arch_t kind = 0; kind < particle_kind_t::Total; ++kind) {
+		auto& bucket = buckets[kind];
+		const arch_t length = bucket.size();
+		if (length == 0) {
+			continue;
+		}
+		const particle_spec_t& spec = kSpecs[kind];
+		if (spec.colliding) {
+			this->collide(static_cast<particle_kind_t>(kind), tilemap);
+		} else {
+			glm::vec2* positions = bucket.positions.data();
+			const glm::vec2* velocities = bucket.velocities.data();
+			for (arch_t it = 0; it < length; ++it) {
+				positions[it] += velocities[it];
+			}
+		}
+		// Straight-line loops over plain arrays, so the compiler can vectorize them
+		glm::vec2* velocities = bucket.velocities.data();
+		real_t* alphas = bucket.alphas.data();
+		sint_t* lifetimes = bucket.lifetimes.data();
+		// Weightless kinds keep whatever vertical speed they were given
+		if (spec.gravity != 0.0f) {
+			for (arch_t it = 0; it < length; ++it) {
+				velocities[it].y = glm::min(velocities[it].y + spec.gravity, kFallLimit);
+			}
+		}
+		for (arch_t it = 0; it < length; ++it) {
+			alphas[it] -= spec.fade;
+		}
+		for (arch_t it = 0; it < length; ++it) {
+			lifetimes[it] -= 1;
+		}
+		bucket.compact();
+	}
+}
+
+void particle_engine_t::update(real64_t delta) {
+	for (arch_t kind = 0; kind < particle_kind_t::Total; ++kind) {
+		auto& bucket = buckets[kind];
+		const animation_t* file = animations[kind];
+		if (file) {
+			const arch_t state = kSpecs[kind].state;
+			const arch_t length = bucket.size();
+			for (arch_t it = 0; it < length; ++it) {
+				file->update(delta, state, bucket.timers[it], bucket.frames[it]);
+			}
+		}
+	}
+}
+
+void particle_engine_t::render(renderer_t& renderer, const rect_t& viewport) const {
+	for (arch_t kind = 0; kind < particle_kind_t::Total; ++kind) {
+		auto& bucket = buckets[kind];
+		const animation_t* file = animations[kind];
+		if (file and bucket.size() > 0) {
+			file->render(
+				renderer,
+				viewport,
+				kSpecs[kind].state,
+				kParticleLayer,
+				bucket.size(),
+				bucket.positions.data(),
+				bucket.frames.data(),
+				bucket.alphas.data()
+			);
+		}
+	}
+}
+
+void particle_engine_t::write(snapshot_writer_t& writer) const {
+	for (auto&& bucket : buckets) {
+		writer.array(bucket.positions);
+		writer.array(bucket.velocities);
+		writer.array(bucket.flags);
+		writer.array(bucket.timers);
+		writer.array(bucket.frames);
+		writer.array(bucket.alphas);
+		writer.array(bucket.lifetimes);
+	}
+}
+
+bool particle_engine_t::read(snapshot_reader_t& reader) {
+	for (auto&& bucket : buckets) {
+		reader.array(bucket.positions);
+		reader.array(bucket.velocities);
+		reader.array(bucket.flags);
+		reader.array(bucket.timers);
+		reader.array(bucket.frames);
+		reader.array(bucket.alphas);
+		reader.array(bucket.lifetimes);
+		const arch_t length = bucket.positions.size();
+		if (
+			bucket.velocities.size() != length or
+			bucket.flags.size() != length or
+			bucket.timers.size() != length or
+			bucket.frames.size() != length or
+			bucket.alphas.size() != length or
+			bucket.lifetimes.size() != length
+		) {
+			bucket.clear();
+			return false;
+		}
+	}
+	return reader.valid();
+}
+
+arch_t particle_engine_t::size() const {
+	arch_t result = 0;
+	for (auto&& bucket : buckets) {
+		result += bucket.size();
+	}
+	return result;
+}
+
+arch_t particle_engine_t::capacity() const {
+	arch_t result = 0;
+	for (auto&& bucket : buckets) {
+		result += bucket.capacity();
+	}
+	return result;
+}
+
+particle_kind_t particle_engine_t::kind(const entt::hashed_string& type) {
+	for (arch_t kind = 0; kind < particle_kind_t::Total; ++kind) {
+		if (kSpecs[kind].type.value() == type.value()) {
+			return static_cast<particle_kind_t>(kind);
+		}
+	}
+	return particle_kind_t::Total;
+}
+
+void particle_engine_t::collide(particle_kind_t kind, const tilemap_t& tilemap) {
+	auto& bucket = buckets[kind];
+	const arch_t length = bucket.size();
+	const particle_spec_t& spec = kSpecs[kind];
+	for (arch_t it = 0; it < length; ++it) {
+		location_t location { bucket.positions[it] };
+		location.bounding = spec.bounding;
+		kinematics_t kinematics { bucket.velocities[it] };
+		kinematics.flags = bucket.flags[it];
+		// Particles never pull regions in, they just wait for the camera to stream them
+		if (!tilemap.resident(location.hitbox(), kinematics.velocity)) {
+			continue;
+		}
+		kinematics_t::handle(location, kinematics, tilemap, kinematics.velocity);
+		if (kinematics.hori_sides()) {
+			kinematics.decel_y(spec.friction);
+		} else if (kinematics.vert_sides()) {
+			kinematics.decel_x(spec.friction);
+		}
+		bucket.positions[it] = location.position;
+		bucket.velocities[it] = kinematics.velocity;
+		bucket.flags[it] = kinematics.flags;
+	}
+}
+
+const animation_t* particle_engine_t::animation(particle_kind_t kind) {
+	if (!animations[kind]) {
+		animations[kind] = vfs_t::animation(kSpecs[kind].entry);
+	}
+	return animations[kind];
+}
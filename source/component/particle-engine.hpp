@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <vector>
+#include <entt/core/hashed_string.hpp>
+
+#include "./common.hpp"
+
+#include "../utility/rect.hpp"
+#include "../utility/enums.hpp"
+
+struct animation_t;
+struct renderer_t;
+struct tilemap_t;
+struct snapshot_writer_t;
+struct snapshot_reader_t;
+
+namespace __enum_particle_kind {
+	enum type : arch_t {
+		Smoke,
+		Shrapnel,
+		Dust,
+		Splash,
+		BlastSmall,
+		BlastMedium,
+		BlastLarge,
+		EnergyTrail,
+		DashFlash,
+		Total
+	};
+}
+
+using particle_kind_t = __enum_particle_kind::type;
+
+// Every field is its own array, so integration walks contiguous memory
+struct particle_bucket_t {
+public:
+	particle_bucket_t() = default;
+	particle_bucket_t(const particle_bucket_t&) = default;
+	particle_bucket_t& operator=(const particle_bucket_t&) = default;
+	particle_bucket_t(particle_bucket_t&&) noexcept = default;
+	particle_bucket_t& operator=(particle_bucket_t&&) noexcept = default;
+	~particle_bucket_t() = default;
+public:
+	void clear();
+	void push(const glm::vec2& position, const glm::vec2& velocity, sint_t lifetime);
+	void compact();
+	arch_t size() const;
+	arch_t capacity() const;
+public:
+	static constexpr arch_t Stride = sizeof(glm::vec2) * 2 + sizeof(std::bitset<phy_t::Total>) + sizeof(real64_t) + sizeof(arch_t) + sizeof(real_t) + sizeof(sint_t);
+public:
+	std::vector<glm::vec2> positions {};
+	std::vector<glm::vec2> velocities {};
+	// Contact flags carry over between ticks, like they did on particle actors
+	std::vector<std::bitset<phy_t::Total> > flags {};
+	std::vector<real64_t> timers {};
+	std::vector<arch_t> frames {};
+	std::vector<real_t> alphas {};
+	std::vector<sint_t> lifetimes {};
+};
+
+struct particle_engine_t : public not_copyable_t {
+public:
+	particle_engine_t() = default;
+	particle_engine_t(particle_engine_t&&) noexcept = default;
+	particle_engine_t& operator=(particle_engine_t&&) noexcept = default;
+	~particle_engine_t() = default;
+public:
+	void reset();
+	bool emit(const entt::hashed_string& type, const glm::vec2& position, const glm::vec2& velocity, direction_t direction);
+	void emit(particle_kind_t kind, const glm::vec2& position, const glm::vec2& velocity, direction_t direction, arch_t count);
+	void handle(const tilemap_t& tilemap);
+	void update(real64_t delta);
+	void render(renderer_t& renderer, const rect_t& viewport) const;
+	void write(snapshot_writer_t& writer) const;
+	bool read(snapshot_reader_t& reader);
+	arch_t size() const;
+	arch_t capacity() const;
+public:
+	static particle_kind_t kind(const entt::hashed_string& type);
+private:
+	void collide(particle_kind_t kind, const tilemap_t& tilemap);
+	const animation_t* animation(particle_kind_t kind);
+private:
+	std::array<particle_bucket_t, particle_kind_t::Total> buckets {};
+	std::array<const animation_t*, particle_kind_t::Total> animations {};
+	std::vector<real_t> randoms {};
+};
@@ -31,9 +31,71 @@ bool routine_ctor_generator_t::init(std::unordered_map<entt::id_type, routine_ct
 	return result;
 }
 
+// Tick Table
+static std::vector<void(*)(std::unordered_map<entt::id_type, routine_tick_fn>&)>& get_tick_callback_list() {
+	static std::vector<void(*)(std::unordered_map<entt::id_type, routine_tick_fn>&)> tick_callback_list;
+	return tick_callback_list;
+}
+
+routine_tick_generator_t::routine_tick_generator_t(void(*callback)(std::unordered_map<entt::id_type, routine_tick_fn>&)) {
+	auto& tick_callback_list = get_tick_callback_list();
+	tick_callback_list.emplace_back(callback);
+}
+
+bool routine_tick_generator_t::init(std::unordered_map<entt::id_type, routine_tick_fn>& tick_table) {
+	bool result = true;
+	auto& callback_list = get_tick_callback_list();
+	for (auto&& callback : callback_list) {
+		if (callback) {
+			std::invoke(callback, tick_table);
+		} else {
+			synao_log("Tick table should not have null entries!\n");
+			result = false;
+			break;
+		}
+	}
+	callback_list.clear();
+	callback_list.shrink_to_fit();
+	return result;
+}
+
+// Batch Table
+static std::vector<void(*)(std::unordered_map<routine_tick_fn, routine_batch_fn>&)>& get_batch_callback_list() {
+	static std::vector<void(*)(std::unordered_map<routine_tick_fn, routine_batch_fn>&)> batch_callback_list;
+	return batch_callback_list;
+}
+
+routine_batch_generator_t::routine_batch_generator_t(void(*callback)(std::unordered_map<routine_tick_fn, routine_batch_fn>&)) {
+	auto& batch_callback_list = get_batch_callback_list();
+	batch_callback_list.emplace_back(callback);
+}
+
+bool routine_batch_generator_t::init(std::unordered_map<routine_tick_fn, routine_batch_fn>& batch_table) {
+	bool result = true;
+	auto& callback_list = get_batch_callback_list();
+	for (auto&& callback : callback_list) {
+		if (callback) {
+			std::invoke(callback, batch_table);
+		} else {
+			synao_log("Batch table should not have null entries!\n");
+			result = false;
+			break;
+		}
+	}
+	callback_list.clear();
+	callback_list.shrink_to_fit();
+	return result;
+}
+
 void routine_t::handle(const input_t& input, audio_t& audio, kernel_t& kernel, receiver_t& receiver, headsup_gui_t& headsup_gui, camera_t& camera, naomi_state_t& naomi, kontext_t& kontext, const tilemap_t& tilemap) {
-	auto view = kontext.slice<routine_t>();
-	if (!view.empty()) {
+	// Keep identical ticks adjacent, so each AI function runs back to back. Names
+	// order the runs the same way in every build, and the sort is stable, so actors
+	// sharing a tick keep their registry order
+	kontext.resort<routine_t>([&kontext](const routine_t& lhv, const routine_t& rhv) {
+		return kontext.routine_order(lhv.tick) < kontext.routine_order(rhv.tick);
+	});
+	auto view = kontext.awake<routine_t>();
+	if (view.begin() != view.end()) {
 		routine_tuple_t rtp(
 			input,
 			audio,
@@ -45,8 +107,30 @@ void routine_t::handle(const input_t& input, audio_t& audio, kernel_t& kernel, r
 			kontext,
 			tilemap
 		);
-		view.each([&rtp](entt::entity actor, routine_t& routine) {
-			routine.tick(actor, rtp);
-		});
+		// Structural changes wait for the flush, so the view stays put while ticking
+		auto& broadphase = kontext.get_broadphase();
+		auto& group = kontext.get_tick_group();
+		auto iter = view.begin();
+		while (iter != view.end()) {
+			const routine_tick_fn tick = view.get<routine_t>(*iter).tick;
+			group.clear();
+			while (iter != view.end() and view.get<routine_t>(*iter).tick == tick) {
+				group.push_back(*iter);
+				++iter;
+			}
+			const routine_batch_fn batch = kontext.batch(tick);
+			// Queries later in the tick must see where each actor moved to
+			if (batch) {
+				batch(group.data(), group.size(), rtp);
+				for (auto&& actor : group) {
+					broadphase.refresh(actor, kontext);
+				}
+			} else {
+				for (auto&& actor : group) {
+					tick(actor, rtp);
+					broadphase.refresh(actor, kontext);
+				}
+			}
+		}
 	}
 }
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <functional>
 #include <entt/core/hashed_string.hpp>
 #include <entt/entity/fwd.hpp>
 
@@ -45,6 +46,7 @@ public:
 
 using routine_ctor_fn = void(*)(entt::entity, kontext_t&);
 using routine_tick_fn = void(*)(entt::entity, routine_tuple_t&);
+using routine_batch_fn = void(*)(const entt::entity*, arch_t, routine_tuple_t&);
 
 struct routine_ctor_generator_t : public not_copyable_t, public not_moveable_t {
 public:
@@ -54,6 +56,23 @@ public:
 	static bool init(std::unordered_map<entt::id_type, routine_ctor_fn>& ctor_table);
 };
 
+struct routine_batch_generator_t : public not_copyable_t, public not_moveable_t {
+public:
+	routine_batch_generator_t(void(*callback)(std::unordered_map<routine_tick_fn, routine_batch_fn>&));
+	~routine_batch_generator_t() = default;
+public:
+	static bool init(std::unordered_map<routine_tick_fn, routine_batch_fn>& batch_table);
+};
+
+// Ticks are saved by name, since a code address means nothing to another build
+struct routine_tick_generator_t : public not_copyable_t, public not_moveable_t {
+public:
+	routine_tick_generator_t(void(*callback)(std::unordered_map<entt::id_type, routine_tick_fn>&));
+	~routine_tick_generator_t() = default;
+public:
+	static bool init(std::unordered_map<entt::id_type, routine_tick_fn>& tick_table);
+};
+
 struct routine_t {
 public:
 	routine_t(routine_tick_fn tick) :
@@ -76,4 +95,14 @@ public:
 	static const routine_ctor_generator_t SYM##___routine_ctor_generator(SYM##___routine_ctor_func);	\
 	static void SYM##___routine_ctor_func(std::unordered_map<entt::id_type, routine_ctor_fn>& table)	\
 
+#define LEVIATHAN_BATCH_TABLE_CREATE(SYM)										\
+	static void SYM##___routine_batch_func(std::unordered_map<routine_tick_fn, routine_batch_fn>& table);	\
+	static const routine_batch_generator_t SYM##___routine_batch_generator(SYM##___routine_batch_func);	\
+	static void SYM##___routine_batch_func(std::unordered_map<routine_tick_fn, routine_batch_fn>& table)	\
+
+#define LEVIATHAN_TICK_TABLE_CREATE(SYM)										\
+	static void SYM##___routine_tick_func(std::unordered_map<entt::id_type, routine_tick_fn>& table);	\
+	static const routine_tick_generator_t SYM##___routine_tick_generator(SYM##___routine_tick_func);	\
+	static void SYM##___routine_tick_func(std::unordered_map<entt::id_type, routine_tick_fn>& table)	\
+
 #define LEVIATHAN_TABLE_PUSH(ACTOR, DATA) table[ACTOR] = DATA
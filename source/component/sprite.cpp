@@ -21,9 +21,6 @@ void sprite_t::reset() {
 	frame = 0;
 	layer = layer_value::Automatic;
 	scale = glm::one<glm::vec2>();
-	pivot = glm::zero<glm::vec2>();
-	angle = 0.0f;
-	shake = 0.0f;
 }
 
 void sprite_t::new_state(arch_t state) {
@@ -51,7 +48,7 @@ bool sprite_t::finished() const {
 }
 
 void sprite_t::update(kontext_t& kontext, real64_t delta) {
-	kontext.slice<sprite_t>().each([delta](entt::entity, sprite_t& sprite) {
+	kontext.awake<sprite_t>().each([delta](entt::entity, sprite_t& sprite) {
 		if (sprite.file) {
 			sprite.file->update(
 				delta,
@@ -59,20 +56,18 @@ void sprite_t::update(kontext_t& kontext, real64_t delta) {
 				sprite.timer,
 				sprite.frame
 			);
-			if (sprite.shake != 0.0f) {
-				real_t amount = static_cast<real_t>(delta / 2.0f);
-				sprite.shake = sprite.shake > 0.0f ?
-					sprite.shake = -glm::max(0.0f, sprite.shake - amount) :
-					sprite.shake = -glm::min(0.0f, sprite.shake + amount);
-			}
 		}
 	});
+	sprite_rotation_t::update(kontext, delta);
 }
 
 void sprite_t::render(const kontext_t& kontext, renderer_t& renderer, const rect_t& viewport) {
-	kontext.slice<sprite_t, location_t>().each([&renderer, &viewport](entt::entity, const sprite_t& sprite, const location_t& location) {
+	kontext.present<sprite_t, location_t>().each([&kontext, &renderer, &viewport](entt::entity actor, const sprite_t& sprite, const location_t& location) {
 		if (sprite.file and sprite.layer != layer_value::Invisible) {
-			if ((sprite.angle + sprite.shake) != 0.0f) {
+			const sprite_rotation_t* rotation = kontext.has<sprite_rotation_t>(actor) ?
+				&kontext.get<sprite_rotation_t>(actor) :
+				nullptr;
+			if (rotation and (rotation->angle + rotation->shake) != 0.0f) {
 				sprite.file->render(
 					renderer,
 					viewport,
@@ -84,8 +79,8 @@ void sprite_t::render(const kontext_t& kontext, renderer_t& renderer, const rect
 					sprite.alpha,
 					location.position,
 					sprite.scale,
-					sprite.angle + sprite.shake,
-					sprite.pivot
+					rotation->angle + rotation->shake,
+					rotation->pivot
 				);
 			} else {
 				sprite.file->render(
@@ -104,3 +99,14 @@ void sprite_t::render(const kontext_t& kontext, renderer_t& renderer, const rect
 		}
 	});
 }
+
+void sprite_rotation_t::update(kontext_t& kontext, real64_t delta) {
+	const real_t amount = static_cast<real_t>(delta / 2.0f);
+	kontext.awake<sprite_rotation_t>().each([amount](entt::entity, sprite_rotation_t& rotation) {
+		if (rotation.shake != 0.0f) {
+			rotation.shake = rotation.shake > 0.0f ?
+				-glm::max(0.0f, rotation.shake - amount) :
+				-glm::min(0.0f, rotation.shake + amount);
+		}
+	});
+}
@@ -26,9 +26,6 @@ public:
 			std::swap(frame, that.frame);
 			std::swap(layer, that.layer);
 			std::swap(scale, that.scale);
-			std::swap(pivot, that.pivot);
-			std::swap(angle, that.angle);
-			std::swap(shake, that.shake);
 		}
 	}
 	sprite_t& operator=(sprite_t&& that) noexcept {
@@ -42,9 +39,6 @@ public:
 			std::swap(frame, that.frame);
 			std::swap(layer, that.layer);
 			std::swap(scale, that.scale);
-			std::swap(pivot, that.pivot);
-			std::swap(angle, that.angle);
-			std::swap(shake, that.shake);
 		}
 		return *this;
 	}
@@ -76,6 +70,22 @@ public:
 	arch_t frame { 0 };
 	layer_t layer { layer_value::Automatic };
 	glm::vec2 scale { 1.0f };
+};
+
+// Rotation is rare, so it lives beside sprite_t instead of inside it
+struct sprite_rotation_t {
+public:
+	sprite_rotation_t(const glm::vec2& pivot) :
+		pivot(pivot) {}
+	sprite_rotation_t() = default;
+	sprite_rotation_t(const sprite_rotation_t&) = default;
+	sprite_rotation_t& operator=(const sprite_rotation_t&) = default;
+	sprite_rotation_t(sprite_rotation_t&&) noexcept = default;
+	sprite_rotation_t& operator=(sprite_rotation_t&&) noexcept = default;
+	~sprite_rotation_t() = default;
+public:
+	static void update(kontext_t& kontext, real64_t delta);
+public:
 	glm::vec2 pivot {};
 	real_t angle { 0.0f };
 	real_t shake { 0.0f };
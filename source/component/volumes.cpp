@@ -0,0 +1,63 @@
+#include "./volumes.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+void volume_index_t::reset() {
+	entries.clear();
+	offsets.clear();
+	indices.clear();
+	origin = glm::zero<glm::vec2>();
+	dimensions = glm::zero<glm::ivec2>();
+}
+
+void volume_index_t::insert(entt::entity actor, const entt::hashed_string& kind, const rect_t& hitbox) {
+	entries.push_back({ actor, kind.value(), hitbox });
+}
+
+void volume_index_t::bake() {
+	offsets.clear();
+	indices.clear();
+	if (entries.empty()) {
+		return;
+	}
+
+	// Cover every volume with one grid
+	glm::vec2 minimum = entries[0].hitbox.left_top();
+	glm::vec2 maximum = entries[0].hitbox.right_bottom();
+	for (auto&& entry : entries) {
+		minimum = glm::min(minimum, entry.hitbox.left_top());
+		maximum = glm::max(maximum, entry.hitbox.right_bottom());
+	}
+	origin = minimum;
+	dimensions = glm::max(
+		glm::ivec2(glm::ceil((maximum - minimum) / static_cast<real_t>(volume_index_t::CellSize))),
+		glm::ivec2(1)
+	);
+
+	// Count, then scatter entry indices into their cells
+	const arch_t total = static_cast<arch_t>(dimensions.x) * static_cast<arch_t>(dimensions.y);
+	offsets.assign(total + 1, 0);
+	for (auto&& entry : entries) {
+		const glm::ivec2 first = this->cell(entry.hitbox.left_top());
+		const glm::ivec2 last = this->cell(entry.hitbox.right_bottom());
+		for (sint_t y = first.y; y <= last.y; ++y) {
+			for (sint_t x = first.x; x <= last.x; ++x) {
+				offsets[static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(dimensions.x) + 1]++;
+			}
+		}
+	}
+	for (arch_t it = 1; it < offsets.size(); ++it) {
+		offsets[it] += offsets[it - 1];
+	}
+	std::vector<arch_t> cursors { offsets.begin(), offsets.end() - 1 };
+	indices.resize(offsets.back());
+	for (arch_t index = 0; index < entries.size(); ++index) {
+		const glm::ivec2 first = this->cell(entries[index].hitbox.left_top());
+		const glm::ivec2 last = this->cell(entries[index].hitbox.right_bottom());
+		for (sint_t y = first.y; y <= last.y; ++y) {
+			for (sint_t x = first.x; x <= last.x; ++x) {
+				indices[cursors[static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(dimensions.x)]++] = index;
+			}
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <entt/core/hashed_string.hpp>
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
+#include <glm/common.hpp>
+
+#include "../utility/rect.hpp"
+
+// Static map volumes are baked into a fixed grid once per field
+struct volume_index_t : public not_copyable_t {
+public:
+	volume_index_t() = default;
+	volume_index_t(volume_index_t&&) noexcept = default;
+	volume_index_t& operator=(volume_index_t&&) noexcept = default;
+	~volume_index_t() = default;
+public:
+	void reset();
+	void insert(entt::entity actor, const entt::hashed_string& kind, const rect_t& hitbox);
+	void bake();
+	template<typename Func>
+	void query(const entt::hashed_string& kind, const rect_t& zone, Func&& func) const;
+	arch_t size() const;
+public:
+	static constexpr sint_t CellSize = 128;
+private:
+	struct entry_t {
+	public:
+		entt::entity actor { entt::null };
+		entt::id_type kind { 0 };
+		rect_t hitbox {};
+	};
+	glm::ivec2 cell(const glm::vec2& position) const;
+private:
+	std::vector<entry_t> entries {};
+	std::vector<arch_t> offsets {};
+	std::vector<arch_t> indices {};
+	glm::vec2 origin {};
+	glm::ivec2 dimensions {};
+};
+
+inline arch_t volume_index_t::size() const {
+	return entries.size();
+}
+
+inline glm::ivec2 volume_index_t::cell(const glm::vec2& position) const {
+	const glm::ivec2 result { glm::floor((position - origin) / static_cast<real_t>(volume_index_t::CellSize)) };
+	return glm::clamp(result, glm::ivec2(0), dimensions - 1);
+}
+
+template<typename Func>
+inline void volume_index_t::query(const entt::hashed_string& kind, const rect_t& zone, Func&& func) const {
+	if (indices.empty()) {
+		return;
+	}
+	const glm::ivec2 first = this->cell(zone.left_top());
+	const glm::ivec2 last = this->cell(zone.right_bottom());
+	for (sint_t y = first.y; y <= last.y; ++y) {
+		for (sint_t x = first.x; x <= last.x; ++x) {
+			const arch_t index = static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(dimensions.x);
+			for (arch_t it = offsets[index]; it < offsets[index + 1]; ++it) {
+				auto& entry = entries[indices[it]];
+				if (entry.kind == kind.value() and entry.hitbox.overlaps(zone)) {
+					// Only report from the cell holding the overlap's corner
+					const glm::ivec2 corner = this->cell({
+						glm::max(zone.x, entry.hitbox.x),
+						glm::max(zone.y, entry.hitbox.y)
+					});
+					if (corner.x == x and corner.y == y) {
+						std::invoke(func, entry.actor, entry.hitbox);
+					}
+				}
+			}
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include "../actor/naomi.hpp"
 #include "../component/kontext.hpp"
 #include "../component/location.hpp"
+#include "../system/snapshot.hpp"
 #include "../utility/constants.hpp"
 #include "../utility/rng.hpp"
 #include "../video/display-list.hpp"
@@ -54,11 +55,11 @@ void camera_t::update(real64_t delta) {
 		} else {
 			cycling = true;
 			offsets = glm::vec2(
-				rng::next(-quake_power, quake_power),
-				rng::next(-quake_power, quake_power)
+				rng::next(rng_stream_t::Camera, -quake_power, quake_power),
+				rng::next(rng_stream_t::Camera, -quake_power, quake_power)
 			);
 			view_angle = glm::radians(
-				rng::next(-quake_power, quake_power)
+				rng::next(rng_stream_t::Camera, -quake_power, quake_power)
 			);
 		}
 		if (!indefinite) {
@@ -74,6 +75,33 @@ void camera_t::update(real64_t delta) {
 	}
 }
 
+void camera_t::write(snapshot_writer_t& writer) const {
+	writer.value(identity);
+	writer.value(cycling);
+	writer.value(indefinite);
+	writer.value(timer);
+	writer.value(view_limits);
+	writer.value(position);
+	writer.value(dimensions);
+	writer.value(offsets);
+	writer.value(quake_power);
+	writer.value(view_angle);
+}
+
+bool camera_t::read(snapshot_reader_t& reader) {
+	reader.value(identity);
+	reader.value(cycling);
+	reader.value(indefinite);
+	reader.value(timer);
+	reader.value(view_limits);
+	reader.value(position);
+	reader.value(dimensions);
+	reader.value(offsets);
+	reader.value(quake_power);
+	reader.value(view_angle);
+	return reader.valid();
+}
+
 void camera_t::set_view_limits(const rect_t& view_limits) {
 	this->view_limits.w = view_limits.w - 16.0f;
 	this->view_limits.h = view_limits.h - 2.0f;
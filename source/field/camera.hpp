@@ -6,6 +6,8 @@
 
 struct kontext_t;
 struct naomi_state_t;
+struct snapshot_writer_t;
+struct snapshot_reader_t;
 
 struct camera_t : public not_copyable_t {
 public:
@@ -17,6 +19,8 @@ public:
 	void reset();
 	void handle(const kontext_t& kontext, const naomi_state_t& naomi_state);
 	void update(real64_t delta);
+	void write(snapshot_writer_t& writer) const;
+	bool read(snapshot_reader_t& reader);
 	void set_view_limits(const rect_t& view_limits);
 	void set_focus(const glm::vec2& position);
 	void follow(sint_t identity);
@@ -3,8 +3,10 @@
 
 #include "../system/renderer.hpp"
 #include "../utility/constants.hpp"
+#include "../video/sampler.hpp"
 #include "../video/texture.hpp"
 
+#include <glm/common.hpp>
 #include <glm/gtc/constants.hpp>
 #include <tmxlite/TileLayer.hpp>
 
@@ -12,13 +14,12 @@ namespace {
 	constexpr arch_t kScreenWidth  = (constants::NormalWidth<arch_t>() / constants::TileSize<arch_t>()) + 1;
 	constexpr arch_t kScreenHeight = (constants::NormalHeight<arch_t>() / constants::TileSize<arch_t>()) + 1;
 	constexpr arch_t kMinimumVerts = kScreenWidth * kScreenHeight * display_list_t::SingleQuad;
-	constexpr sint_t kInvalidTiles = -1;
 	constexpr byte_t kCollideLayer[] = "collide";
 	constexpr byte_t kPriorityType[] = "priority";
 }
 
 tilemap_layer_t::tilemap_layer_t(const glm::ivec2& dimensions) : tilemap_layer_t() {
-	tiles.resize(
+	sources.resize(
 		static_cast<arch_t>(dimensions.x) *
 		static_cast<arch_t>(dimensions.y)
 	);
@@ -30,7 +31,7 @@ tilemap_layer_t::tilemap_layer_t() {
 	quads.setup(specify);
 }
 
-void tilemap_layer_t::init(const std::unique_ptr<tmx::Layer>& layer, const glm::vec2& inverse_dimensions, std::vector<uint_t>& attributes, const std::vector<uint_t>& attribute_key) {
+void tilemap_layer_t::init(const std::unique_ptr<tmx::Layer>& layer, const glm::vec2& inverse_dimensions) {
 	assert(layer);
 	// Set dimensions
 	glm::vec2 inv = inverse_dimensions;
@@ -40,7 +41,6 @@ void tilemap_layer_t::init(const std::unique_ptr<tmx::Layer>& layer, const glm::
 	this->inverse_dimensions = inv;
 
 	// Find the collision layer
-	bool colliding = false;
 	for (auto&& property : layer->getProperties()) {
 		auto& name = property.getName();
 		if (name == kCollideLayer) {
@@ -53,20 +53,77 @@ void tilemap_layer_t::init(const std::unique_ptr<tmx::Layer>& layer, const glm::
 		}
 	}
 
-	// Populate tile array
+	// Keep raw tile IDs only; tiles and attributes are decoded on demand
 	auto& array = static_cast<tmx::TileLayer*>(layer.get())->getTiles();
-	for (arch_t it = 0; it < array.size(); ++it) {
-		sint_t type = static_cast<sint_t>(array[it].ID) - 1;
-		tiles[it] = type >= 0 ?
-			glm::ivec2 { type % constants::TileSize<sint_t>(), type / constants::TileSize<sint_t>() } :
-			glm::ivec2 { kInvalidTiles };
-		if (colliding and type >= 0) {
-			attributes[it] = attribute_key[type];
+	const arch_t length = glm::min(array.size(), sources.size());
+	for (arch_t it = 0; it < length; ++it) {
+		sources[it] = static_cast<uint16_t>(array[it].ID);
+	}
+}
+
+void tilemap_layer_t::upload(sampler_indices_t& indices, sint_t slice) {
+	// Tile IDs go to the GPU as-is, so one quad can draw the whole layer
+	indices.update(sources.data(), slice);
+	this->slice = slice;
+	quads.setup(vertex_spec_t::from(vtx_tiles_t::name()));
+	quads.resize(display_list_t::SingleQuad);
+}
+
+void tilemap_layer_t::decode(const glm::ivec2& first, const glm::ivec2& last, const glm::ivec2& dimensions, arch_t stride, const std::vector<uint_t>& attribute_key, std::vector<uint_t>& attributes) const {
+	if (!colliding) {
+		return;
+	}
+	for (sint_t y = first.y; y < last.y; ++y) {
+		for (sint_t x = first.x; x < last.x; ++x) {
+			const arch_t index = static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(dimensions.x);
+			const sint_t type = static_cast<sint_t>(sources[index]) - 1;
+			if (type >= 0) {
+				attributes[
+					static_cast<arch_t>(x - first.x) +
+					static_cast<arch_t>(y - first.y) * stride
+				] = attribute_key[type];
+			}
 		}
 	}
 }
 
 void tilemap_layer_t::handle(arch_t range, const glm::ivec2& first, const glm::ivec2& last, const glm::ivec2& dimensions, const texture_t* texture) {
+	if (slice >= 0) {
+		indices = 0;
+		if (first.x < last.x and first.y < last.y) {
+			const glm::vec2 left_top { first };
+			const glm::vec2 right_bottom { last };
+			const sint_t texID = texture ? texture->get_name() : 0;
+
+			vtx_tiles_t* quad = quads.at<vtx_tiles_t>(0);
+			quad[0].position = left_top * constants::TileSize<real_t>();
+			quad[0].matrix = 1;
+			quad[0].uvcoords = left_top;
+			quad[0].texID = texID;
+			quad[0].index = slice;
+
+			quad[1].position = glm::vec2(left_top.x, right_bottom.y) * constants::TileSize<real_t>();
+			quad[1].matrix = 1;
+			quad[1].uvcoords = { left_top.x, right_bottom.y };
+			quad[1].texID = texID;
+			quad[1].index = slice;
+
+			quad[2].position = glm::vec2(right_bottom.x, left_top.y) * constants::TileSize<real_t>();
+			quad[2].matrix = 1;
+			quad[2].uvcoords = { right_bottom.x, left_top.y };
+			quad[2].texID = texID;
+			quad[2].index = slice;
+
+			quad[3].position = right_bottom * constants::TileSize<real_t>();
+			quad[3].matrix = 1;
+			quad[3].uvcoords = right_bottom;
+			quad[3].texID = texID;
+			quad[3].index = slice;
+
+			indices = 1;
+		}
+		return;
+	}
 	if (range != quads.size()) {
 		quads.resize(range);
 	}
@@ -79,9 +136,10 @@ void tilemap_layer_t::handle(arch_t range, const glm::ivec2& first, const glm::i
 	for (sint_t y = first.y; y < last.y; ++y) {
 		for (sint_t x = first.x; x < last.x; ++x) {
 			arch_t index = static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(dimensions.x);
-			glm::ivec2 tile = tiles[index];
+			sint_t type = static_cast<sint_t>(sources[index]) - 1;
 
-			if (tile.x >= 0 and tile.y >= 0) {
+			if (type >= 0) {
+				const glm::ivec2 tile { type % constants::TileSize<sint_t>(), type / constants::TileSize<sint_t>() };
 				uvs = glm::vec2(tile * constants::TileSize<sint_t>());
 
 				vtx_major_t* quad = quads.at<vtx_major_t>(indices * display_list_t::SingleQuad);
@@ -122,7 +180,9 @@ void tilemap_layer_t::render(renderer_t& renderer, bool_t amend) const {
 	auto& list = renderer.display_list(
 		priority,
 		blend_mode_t::Alpha,
-		program_t::Sprites
+		slice >= 0 ?
+			program_t::Tilemap :
+			program_t::Sprites
 	);
 	if (amend) {
 		list.begin(indices * display_list_t::SingleQuad)
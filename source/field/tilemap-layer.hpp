@@ -8,6 +8,7 @@
 
 struct texture_t;
 struct renderer_t;
+struct sampler_indices_t;
 
 struct tilemap_layer_t : public not_copyable_t {
 public:
@@ -17,13 +18,17 @@ public:
 	tilemap_layer_t& operator=(tilemap_layer_t&& that) noexcept = default;
 	~tilemap_layer_t() = default;
 public:
-	void init(const std::unique_ptr<tmx::Layer>& layer, const glm::vec2& inverse_dimensions, std::vector<uint_t>& attributes, const std::vector<uint_t>& attribute_key);
+	void init(const std::unique_ptr<tmx::Layer>& layer, const glm::vec2& inverse_dimensions);
+	void upload(sampler_indices_t& indices, sint_t slice);
+	void decode(const glm::ivec2& first, const glm::ivec2& last, const glm::ivec2& dimensions, arch_t stride, const std::vector<uint_t>& attribute_key, std::vector<uint_t>& attributes) const;
 	void handle(arch_t range, const glm::ivec2& first, const glm::ivec2& last, const glm::ivec2& dimensions, const texture_t* texture);
 	void render(renderer_t& renderer, bool_t amend) const;
 private:
 	layer_t priority { layer_value::Background };
+	bool_t colliding { false };
+	sint_t slice { -1 };
 	arch_t indices { 0 };
 	glm::vec2 inverse_dimensions { 1.0f };
-	std::vector<glm::ivec2> tiles {};
+	std::vector<uint16_t> sources {};
 	vertex_pool_t quads {};
 };
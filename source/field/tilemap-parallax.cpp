@@ -16,6 +16,12 @@ namespace {
 	constexpr byte_t kScrollYProp[] = "scroll.y";
 }
 
+tilemap_parallax_t::tilemap_parallax_t() {
+	vertex_spec_t specify = vertex_spec_t::from(vtx_tiles_t::name());
+	quads.setup(specify);
+	quads.resize(display_list_t::SingleQuad);
+}
+
 void tilemap_parallax_t::init(const std::unique_ptr<tmx::Layer>& layer, const glm::vec2& dimensions) {
 	assert(layer);
 	// Set dimensions
@@ -48,35 +54,45 @@ void tilemap_parallax_t::init(const std::unique_ptr<tmx::Layer>& layer, const gl
 	}
 }
 
-void tilemap_parallax_t::handle(const rect_t& viewport) {
+void tilemap_parallax_t::handle(const rect_t& viewport, bool_t& amend, glm::vec4* parameters) {
 	glm::vec2 next = glm::mod(
 		viewport.left_top() * -scrolling,
 		dimensions
 	);
-	if (position != next) {
-		indices = 0;
+	if (position != next or amend) {
+		amend = true;
 		position = next;
+		parameters[0] = { bounding.x, bounding.y, bounding.w, bounding.h };
+		parameters[1] = { position.x, position.y, dimensions.x, dimensions.y };
 	}
 }
 
-void tilemap_parallax_t::render(renderer_t& renderer, const rect_t& viewport, const texture_t* texture) const {
+void tilemap_parallax_t::render(renderer_t& renderer, const rect_t& viewport, bool_t amend, sint_t index, const texture_t* texture) const {
 	auto& list = renderer.display_list(
 		layer_value::Background,
 		blend_mode_t::Alpha,
-		program_t::Sprites
+		program_t::Parallax
 	);
-	if (indices == 0) {
-		sint_t texID = texture ? texture->get_name() : 0;
-		for (real_t y = viewport.y + position.y - dimensions.y; y < viewport.bottom(); y += dimensions.y) {
-			for (real_t x = viewport.x + position.x - dimensions.x; x < viewport.right(); x += dimensions.x) {
-				list.begin(display_list_t::SingleQuad)
-					.vtx_major_write(bounding, dimensions, mirroring_t::None, 1.0f, texID)
-					.vtx_transform_write(x, y)
-				.end();
-				indices += display_list_t::SingleQuad;
-			}
+	if (amend) {
+		// Screen-space quad, scrolling and wrapping happen in the shader
+		const glm::vec2 right_bottom = viewport.dimensions();
+		const sint_t texID = texture ? texture->get_name() : 0;
+
+		vtx_tiles_t* quad = quads.at<vtx_tiles_t>(0);
+		quad[0].position = glm::zero<glm::vec2>();
+		quad[1].position = { 0.0f, right_bottom.y };
+		quad[2].position = { right_bottom.x, 0.0f };
+		quad[3].position = right_bottom;
+		for (arch_t it = 0; it < display_list_t::SingleQuad; ++it) {
+			quad[it].matrix = 0;
+			quad[it].uvcoords = quad[it].position;
+			quad[it].texID = texID;
+			quad[it].index = index;
 		}
+		list.begin(display_list_t::SingleQuad)
+			.vtx_pool_write(quads)
+		.end();
 	} else {
-		list.skip(indices);
+		list.skip(display_list_t::SingleQuad);
 	}
 }
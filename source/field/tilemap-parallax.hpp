@@ -2,25 +2,27 @@
 
 #include <memory>
 #include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
 #include <tmxlite/Layer.hpp>
 
 #include "../utility/rect.hpp"
+#include "../video/vertex-pool.hpp"
 
 struct texture_t;
 struct renderer_t;
 
 struct tilemap_parallax_t : public not_copyable_t {
 public:
-	tilemap_parallax_t() = default;
+	tilemap_parallax_t();
 	tilemap_parallax_t(tilemap_parallax_t&& that) noexcept = default;
 	tilemap_parallax_t& operator=(tilemap_parallax_t&& that) noexcept = default;
 	~tilemap_parallax_t() = default;
 public:
 	void init(const std::unique_ptr<tmx::Layer>& layer, const glm::vec2& dimensions);
-	void handle(const rect_t& viewport);
-	void render(renderer_t& renderer, const rect_t& viewport, const texture_t* texture) const;
+	void handle(const rect_t& viewport, bool_t& amend, glm::vec4* parameters);
+	void render(renderer_t& renderer, const rect_t& viewport, bool_t amend, sint_t index, const texture_t* texture) const;
 private:
-	mutable arch_t indices { 0 };
+	mutable vertex_pool_t quads {};
 	glm::vec2 position {};
 	glm::vec2 scrolling {};
 	glm::vec2 dimensions { 1.0f };
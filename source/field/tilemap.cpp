@@ -6,7 +6,10 @@
 #include "../resource/vfs.hpp"
 #include "../system/renderer.hpp"
 #include "../utility/constants.hpp"
+#include "../utility/logger.hpp"
+#include "../utility/thread-pool.hpp"
 
+#include <chrono>
 #include <glm/common.hpp>
 #include <glm/gtc/constants.hpp>
 #include <tmxlite/Map.hpp>
@@ -15,28 +18,53 @@
 namespace {
 	constexpr sint_t kScreenWidth  = (constants::NormalWidth<sint_t>() / constants::TileSize<sint_t>()) + 1;
 	constexpr sint_t kScreenHeight = (constants::NormalHeight<sint_t>() / constants::TileSize<sint_t>()) + 1;
+	constexpr sint_t kRegionSize = 32;
+	constexpr sint_t kRegionMargin = 1;
+	constexpr arch_t kResidentRegions = 16;
+}
+
+tilemap_t::~tilemap_t() {
+	this->finish();
 }
 
 void tilemap_t::reset() {
+	this->finish();
 	amend = true;
+	scrolled = true;
+	backdrop = true;
+	uploaded = false;
 	dimensions = glm::zero<glm::ivec2>();
-	attributes.clear();
+	region_dimensions = glm::zero<glm::ivec2>();
+	regions.clear();
 	previous_viewport = rect_t {
 		-constants::TileDimensions<real_t>(),
 		constants::NormalDimensions<real_t>()
 	};
+	tile_indices.destroy();
 	layer_texture = nullptr;
 	parallax_texture = nullptr;
+	parallax_parameters.clear();
 	tilemap_parallaxes.clear();
 	tilemap_layers.clear();
 }
 
 void tilemap_t::handle(const camera_t& camera) {
 	const rect_t viewport = camera.get_viewport();
-	for (auto&& parallax : tilemap_parallaxes) {
-		parallax.handle(viewport);
+	this->stream(viewport);
+	for (arch_t it = 0; it < tilemap_parallaxes.size(); ++it) {
+		tilemap_parallaxes[it].handle(
+			viewport,
+			scrolled,
+			&parallax_parameters[it * 2]
+		);
 	}
-	if (!previous_viewport.round_compare(viewport)) {
+	bool_t rebuild = !previous_viewport.round_compare(viewport);
+	if (!uploaded) {
+		uploaded = true;
+		rebuild = true;
+		this->upload();
+	}
+	if (rebuild) {
 		previous_viewport = viewport;
 		amend = true;
 		const glm::ivec2 first {
@@ -55,29 +83,45 @@ void tilemap_t::handle(const camera_t& camera) {
 }
 
 void tilemap_t::render(renderer_t& renderer, const rect_t& viewport) const {
-	for (auto&& parallax : tilemap_parallaxes) {
-		parallax.render(
+	if (scrolled) {
+		scrolled = false;
+		renderer.update_parallaxes(
+			parallax_parameters.data(),
+			parallax_parameters.size()
+		);
+	}
+	for (arch_t it = 0; it < tilemap_parallaxes.size(); ++it) {
+		tilemap_parallaxes[it].render(
 			renderer,
 			viewport,
+			backdrop,
+			static_cast<sint_t>(it),
 			parallax_texture
 		);
 	}
+	backdrop = false;
 	for (auto&& layer : tilemap_layers) {
 		layer.render(renderer, amend);
 	}
 	amend = false;
 }
 
-void tilemap_t::push_properties(const tmx::Map& tmxmap) {
+void tilemap_t::push_properties(const tmx::Map& tmxmap, const renderer_t& renderer) {
 	// Resize according to tmxmap bounds
 	const tmx::FloatRect bounds = tmxmap.getBounds();
 	dimensions = {
 		glm::max(static_cast<sint_t>(bounds.width) / constants::TileSize<sint_t>(), kScreenWidth),
 		glm::max(static_cast<sint_t>(bounds.height) / constants::TileSize<sint_t>(), kScreenHeight)
 	};
-	attributes.resize(
-		static_cast<arch_t>(dimensions.x) *
-		static_cast<arch_t>(dimensions.y)
+	// Without the tilemap program, layers stay on per-tile sprite quads
+	indexed = renderer.has_tilemap_program();
+	// Split attributes into regions that stream in around the viewport
+	this->finish();
+	region_dimensions = (dimensions + (kRegionSize - 1)) / kRegionSize;
+	regions.clear();
+	regions.resize(
+		static_cast<arch_t>(region_dimensions.x) *
+		static_cast<arch_t>(region_dimensions.y)
 	);
 
 	// Get tileset textures/attributes
@@ -93,24 +137,32 @@ void tilemap_t::push_properties(const tmx::Map& tmxmap) {
 void tilemap_t::push_layer(const std::unique_ptr<tmx::Layer>& layer) {
 	assert(layer);
 	amend = true;
+	uploaded = false;
+	// Resident regions were decoded without this layer
+	this->finish();
+	for (auto&& region : regions) {
+		region.status = region_status_t::Unloaded;
+		region.attributes = std::vector<uint_t>();
+	}
 	if (!attribute_key.empty()) {
 		const glm::vec2 inverse = layer_texture ?
 			layer_texture->get_inverse_dimensions() :
 			glm::zero<glm::vec2>();
 
 		auto& recent = tilemap_layers.emplace_back(dimensions);
-		recent.init(
-			layer,
-			inverse,
-			attributes,
-			attribute_key
-		);
+		recent.init(layer, inverse);
 	}
 }
 
 void tilemap_t::push_parallax(const std::unique_ptr<tmx::Layer>& layer) {
 	assert(layer);
+	if (tilemap_parallaxes.size() >= renderer_t::MaximumParallaxes) {
+		synao_log("Warning! Fields can't have more than {} parallax layers!\n", renderer_t::MaximumParallaxes);
+		return;
+	}
 	amend = true;
+	scrolled = true;
+	backdrop = true;
 	auto& path = static_cast<tmx::ImageLayer*>(layer.get())->getImagePath();
 	parallax_texture = vfs_t::texture(ftcv::path_to_name(path));
 
@@ -119,14 +171,25 @@ void tilemap_t::push_parallax(const std::unique_ptr<tmx::Layer>& layer) {
 		glm::zero<glm::vec2>();
 	auto& recent = tilemap_parallaxes.emplace_back();
 	recent.init(layer, parallax_dimensions);
+	parallax_parameters.resize(tilemap_parallaxes.size() * 2);
 }
 
 uint_t tilemap_t::get_attribute(sint_t x, sint_t y) const {
 	if (x >= 0 and y >= 0 and x < dimensions.x and y < dimensions.y) {
-		return attributes[
-			static_cast<arch_t>(x) +
-			static_cast<arch_t>(y) *
-			static_cast<arch_t>(dimensions.x)
+		const arch_t index =
+			static_cast<arch_t>(x / kRegionSize) +
+			static_cast<arch_t>(y / kRegionSize) *
+			static_cast<arch_t>(region_dimensions.x);
+		auto& region = regions[index];
+		if (region.status != region_status_t::Resident) {
+			// Bodies wait until the regions under them are resident, so this is only
+			// reached by queries that reach far away. Treat the unknown as a wall
+			return tileflag_t::Block;
+		}
+		return region.attributes[
+			static_cast<arch_t>(x % kRegionSize) +
+			static_cast<arch_t>(y % kRegionSize) *
+			static_cast<arch_t>(kRegionSize)
 		];
 	} else if (y > (dimensions.y + 1)) {
 		return tileflag_t::OutBounds;
@@ -134,10 +197,192 @@ uint_t tilemap_t::get_attribute(sint_t x, sint_t y) const {
 	return tileflag_t::Empty;
 }
 
+bool tilemap_t::prepare(const rect_t& area, const glm::vec2& reach) {
+	if (regions.empty()) {
+		return true;
+	}
+	glm::ivec2 first {};
+	glm::ivec2 last {};
+	this->span(area, reach, first, last);
+	// Decodes go to the workers, so the caller waits a few ticks instead of stalling this one
+	bool_t result = true;
+	for (sint_t y = first.y; y <= last.y; ++y) {
+		for (sint_t x = first.x; x <= last.x; ++x) {
+			const arch_t index = static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(region_dimensions.x);
+			this->request(index);
+			regions[index].pinned = true;
+			result = result and regions[index].status == region_status_t::Resident;
+		}
+	}
+	return result;
+}
+
+bool tilemap_t::resident(const rect_t& area, const glm::vec2& reach) const {
+	if (regions.empty()) {
+		return true;
+	}
+	glm::ivec2 first {};
+	glm::ivec2 last {};
+	this->span(area, reach, first, last);
+	for (sint_t y = first.y; y <= last.y; ++y) {
+		for (sint_t x = first.x; x <= last.x; ++x) {
+			const arch_t index = static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(region_dimensions.x);
+			if (regions[index].status != region_status_t::Resident) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 uint_t tilemap_t::get_attribute(glm::ivec2 index) const {
 	return this->get_attribute(index.x, index.y);
 }
 
+void tilemap_t::upload() {
+	tile_indices.destroy();
+	if (!tilemap_layers.empty()) {
+		const sint_t count = static_cast<sint_t>(tilemap_layers.size());
+		// Devices that can't fit the field keep building tile vertices
+		if (indexed and tile_indices.create(dimensions, count)) {
+			for (sint_t it = 0; it < count; ++it) {
+				tilemap_layers[static_cast<arch_t>(it)].upload(tile_indices, it);
+			}
+		}
+	}
+}
+
+void tilemap_t::stream(const rect_t& viewport) {
+	// Small fields stay fully resident
+	if (regions.size() <= kResidentRegions) {
+		for (arch_t index = 0; index < regions.size(); ++index) {
+			this->assure(index);
+		}
+		return;
+	}
+	const glm::ivec2 first {
+		glm::max(tilemap_t::floor(viewport.x) / kRegionSize, 0),
+		glm::max(tilemap_t::floor(viewport.y) / kRegionSize, 0)
+	};
+	const glm::ivec2 last {
+		glm::min(tilemap_t::ceiling(viewport.right()) / kRegionSize, region_dimensions.x - 1),
+		glm::min(tilemap_t::ceiling(viewport.bottom()) / kRegionSize, region_dimensions.y - 1)
+	};
+	for (sint_t y = 0; y < region_dimensions.y; ++y) {
+		for (sint_t x = 0; x < region_dimensions.x; ++x) {
+			const arch_t index = static_cast<arch_t>(x) + static_cast<arch_t>(y) * static_cast<arch_t>(region_dimensions.x);
+			const sint_t distance = glm::max(
+				glm::max(first.x - x, x - last.x),
+				glm::max(first.y - y, y - last.y)
+			);
+			if (distance <= 0) {
+				// Collision inside the viewport can't wait
+				this->assure(index);
+			} else if (distance <= kRegionMargin) {
+				this->request(index);
+			} else if (distance > kRegionMargin + 1 and !regions[index].pinned) {
+				// Regions with bodies in them stay until the bodies leave
+				this->release(index);
+			}
+			regions[index].pinned = false;
+		}
+	}
+}
+
+void tilemap_t::span(const rect_t& area, const glm::vec2& reach, glm::ivec2& first, glm::ivec2& last) const {
+	const glm::vec2 margin = glm::abs(reach) + constants::TileSize<real_t>();
+	first = {
+		glm::clamp(tilemap_t::floor(area.x - margin.x) / kRegionSize, 0, region_dimensions.x - 1),
+		glm::clamp(tilemap_t::floor(area.y - margin.y) / kRegionSize, 0, region_dimensions.y - 1)
+	};
+	last = {
+		glm::clamp(tilemap_t::ceiling(area.right() + margin.x) / kRegionSize, 0, region_dimensions.x - 1),
+		glm::clamp(tilemap_t::ceiling(area.bottom() + margin.y) / kRegionSize, 0, region_dimensions.y - 1)
+	};
+}
+
+void tilemap_t::decode(arch_t index) {
+	auto& region = regions[index];
+	const glm::ivec2 first {
+		static_cast<sint_t>(index % static_cast<arch_t>(region_dimensions.x)) * kRegionSize,
+		static_cast<sint_t>(index / static_cast<arch_t>(region_dimensions.x)) * kRegionSize
+	};
+	const glm::ivec2 last = glm::min(first + kRegionSize, dimensions);
+	region.attributes.assign(
+		static_cast<arch_t>(kRegionSize) *
+		static_cast<arch_t>(kRegionSize),
+		tileflag_t::Empty
+	);
+	for (auto&& layer : tilemap_layers) {
+		layer.decode(
+			first, last,
+			dimensions,
+			static_cast<arch_t>(kRegionSize),
+			attribute_key,
+			region.attributes
+		);
+	}
+}
+
+void tilemap_t::assure(arch_t index) {
+	auto& region = regions[index];
+	if (region.status == region_status_t::Unloaded) {
+		this->decode(index);
+		region.status = region_status_t::Resident;
+	} else if (region.status == region_status_t::Pending) {
+		tilemap_t::wait(region);
+		region.status = region_status_t::Resident;
+	}
+}
+
+void tilemap_t::request(arch_t index) {
+	auto& region = regions[index];
+	if (region.status == region_status_t::Unloaded) {
+		thread_pool_t* workers = vfs_t::workers();
+		if (workers) {
+			region.status = region_status_t::Pending;
+			region.future = workers->push([this](arch_t index) {
+				this->decode(index);
+			}, index);
+		} else {
+			this->decode(index);
+			region.status = region_status_t::Resident;
+		}
+	} else if (region.status == region_status_t::Pending) {
+		if (region.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			region.status = region_status_t::Resident;
+		}
+	}
+}
+
+void tilemap_t::release(arch_t index) {
+	auto& region = regions[index];
+	if (region.status == region_status_t::Resident) {
+		region.status = region_status_t::Unloaded;
+		region.attributes = std::vector<uint_t>();
+	} else if (region.status == region_status_t::Pending) {
+		this->request(index);
+	}
+}
+
+void tilemap_t::finish() {
+	for (auto&& region : regions) {
+		if (region.status == region_status_t::Pending) {
+			tilemap_t::wait(region);
+			region.status = region_status_t::Resident;
+		}
+	}
+}
+
+void tilemap_t::wait(tilemap_region_t& region) {
+	thread_pool_t* workers = vfs_t::workers();
+	if (workers) {
+		workers->wait(region.future);
+	} else {
+		region.future.wait();
+	}
+}
+
 sint_t tilemap_t::round(real_t value) {
 	return static_cast<sint_t>(value) / constants::TileSize<sint_t>();
 }
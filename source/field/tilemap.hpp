@@ -3,19 +3,49 @@
 #include "./tilemap-parallax.hpp"
 #include "./tilemap-layer.hpp"
 
+#include "../video/sampler.hpp"
+
+#include <future>
+
 struct camera_t;
 
+namespace __enum_region_status {
+	enum type : arch_t {
+		Unloaded,
+		Pending,
+		Resident
+	};
+}
+
+using region_status_t = __enum_region_status::type;
+
+struct tilemap_region_t : public not_copyable_t {
+public:
+	tilemap_region_t() = default;
+	tilemap_region_t(tilemap_region_t&&) noexcept = default;
+	tilemap_region_t& operator=(tilemap_region_t&&) noexcept = default;
+	~tilemap_region_t() = default;
+public:
+	region_status_t status { region_status_t::Unloaded };
+	bool_t pinned { false };
+	std::future<void> future {};
+	std::vector<uint_t> attributes {};
+};
+
 struct tilemap_t : public not_copyable_t {
 public:
 	tilemap_t() = default;
-	tilemap_t(tilemap_t&&) noexcept = default;
-	tilemap_t& operator=(tilemap_t&&) noexcept = default;
-	~tilemap_t() = default;
+	// Pending decodes hold on to this, so a tilemap stays where it was made
+	tilemap_t(tilemap_t&&) noexcept = delete;
+	tilemap_t& operator=(tilemap_t&&) noexcept = delete;
+	~tilemap_t();
 public:
 	void reset();
 	void handle(const camera_t& camera);
+	bool prepare(const rect_t& area, const glm::vec2& reach);
+	bool resident(const rect_t& area, const glm::vec2& reach) const;
 	void render(renderer_t& renderer, const rect_t& viewport) const;
-	void push_properties(const tmx::Map& tmxmap);
+	void push_properties(const tmx::Map& tmxmap, const renderer_t& renderer);
 	void push_layer(const std::unique_ptr<tmx::Layer>& layer);
 	void push_parallax(const std::unique_ptr<tmx::Layer>& layer);
 	uint_t get_attribute(sint_t x, sint_t y) const;
@@ -25,14 +55,31 @@ public:
 	static sint_t ceiling(real_t value);
 	static sint_t floor(real_t value);
 	static real_t extend(sint_t value);
+private:
+	void upload();
+	void stream(const rect_t& viewport);
+	void span(const rect_t& area, const glm::vec2& reach, glm::ivec2& first, glm::ivec2& last) const;
+	void decode(arch_t index);
+	void assure(arch_t index);
+	void request(arch_t index);
+	void release(arch_t index);
+	void finish();
+	static void wait(tilemap_region_t& region);
 private:
 	mutable bool_t amend { false };
+	mutable bool_t scrolled { false };
+	mutable bool_t backdrop { false };
+	bool_t uploaded { false };
+	bool_t indexed { false };
 	glm::ivec2 dimensions {};
-	std::vector<uint_t> attributes {};
+	glm::ivec2 region_dimensions {};
+	std::vector<tilemap_region_t> regions {};
 	std::vector<uint_t> attribute_key {};
 	rect_t previous_viewport {};
+	sampler_indices_t tile_indices {};
 	const texture_t* layer_texture { nullptr };
 	const texture_t* parallax_texture { nullptr };
+	std::vector<glm::vec4> parallax_parameters {};
 	std::vector<tilemap_parallax_t> tilemap_parallaxes {};
 	std::vector<tilemap_layer_t> tilemap_layers {};
 };
@@ -6,7 +6,9 @@
 	#define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include "../component/census.hpp"
 #include "../resource/program.hpp"
+#include "../resource/vfs.hpp"
 #include "../system/input.hpp"
 #include "../system/video.hpp"
 #include "../utility/logger.hpp"
@@ -64,7 +66,11 @@ bool meta_state_t::init(const video_t& video) {
 	return true;
 }
 
-void meta_state_t::handle(const input_t& input) {
+namespace {
+	constexpr byte_t kCensusFile[] = "census.csv";
+}
+
+void meta_state_t::handle(const input_t& input, census_t& census) {
 	if (Ready and !amend) {
 		if (input.get_meta_pressed(SDL_SCANCODE_BACKSPACE)) {
 			active = !active;
@@ -75,13 +81,22 @@ void meta_state_t::handle(const input_t& input) {
 			ImGui_ImplSDL2_NewFrame(window);
 			ImGui::NewFrame();
 			// Begin
-			ImGui::BeginMainMenuBar();
-			ImGui::EndMainMenuBar();
+			if (ImGui::BeginMainMenuBar()) {
+				if (ImGui::BeginMenu("View")) {
+					ImGui::MenuItem("Census", nullptr, &census_window);
+					ImGui::EndMenu();
+				}
+				ImGui::EndMainMenuBar();
+			}
+			if (census_window) {
+				this->do_census(census);
+			}
 			// End
 			ImGui::Render();
 		} else {
 			amend = false;
 		}
+		census.enable(active and census_window);
 	}
 }
 
@@ -98,6 +113,57 @@ void meta_state_t::flush() const {
 	}
 }
 
+void meta_state_t::do_census(census_t& census) {
+	if (!ImGui::Begin("Census", &census_window)) {
+		ImGui::End();
+		return;
+	}
+	ImGui::Text(
+		"Frame %llu, %llu spawned, %llu destroyed",
+		static_cast<unsigned long long>(census.get_frame()),
+		static_cast<unsigned long long>(census.get_spawns()),
+		static_cast<unsigned long long>(census.get_destroys())
+	);
+	if (census.is_recording()) {
+		if (ImGui::Button("Stop")) {
+			census.record(false);
+		}
+	} else if (ImGui::Button("Record")) {
+		census.record(true);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV")) {
+		census.write(vfs_t::resource_path(vfs_resource_path_t::Init) + kCensusFile);
+	}
+	if (ImGui::CollapsingHeader("Systems", ImGuiTreeNodeFlags_DefaultOpen)) {
+		for (arch_t it = 0; it < census_system_t::Total; ++it) {
+			const census_system_t system = static_cast<census_system_t>(it);
+			ImGui::Text("%s: %.3f ms", census_t::name(system), census.get_timing(system) * 1000.0);
+		}
+	}
+	if (ImGui::CollapsingHeader("Pools", ImGuiTreeNodeFlags_DefaultOpen)) {
+		ImGui::Columns(4, "census_pools");
+		ImGui::Text("Pool"); ImGui::NextColumn();
+		ImGui::Text("Size"); ImGui::NextColumn();
+		ImGui::Text("Capacity"); ImGui::NextColumn();
+		ImGui::Text("Bytes"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (auto&& pool : census.get_pools()) {
+			ImGui::Text("%s", pool.name); ImGui::NextColumn();
+			ImGui::Text("%llu", static_cast<unsigned long long>(pool.size)); ImGui::NextColumn();
+			ImGui::Text("%llu", static_cast<unsigned long long>(pool.capacity)); ImGui::NextColumn();
+			ImGui::Text("%llu", static_cast<unsigned long long>(pool.bytes)); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+	if (ImGui::CollapsingHeader("Types")) {
+		for (auto&& type : census.get_types()) {
+			ImGui::Text("%s: %llu", type.name, static_cast<unsigned long long>(type.count));
+		}
+	}
+	ImGui::End();
+}
+
 meta_state_t::event_callback_t meta_state_t::get_event_callback() {
 	if (Ready) {
 		return ImGui_ImplSDL2_ProcessEvent;
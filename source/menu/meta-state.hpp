@@ -9,6 +9,7 @@ typedef union SDL_Event SDL_Event;
 struct input_t;
 struct video_t;
 struct renderer_t;
+struct census_t;
 
 #ifdef LEVIATHAN_USES_META
 
@@ -20,17 +21,20 @@ public:
 	~meta_state_t();
 public:
 	bool init(const video_t& video);
-	void handle(const input_t& input);
+	void handle(const input_t& input, census_t& census);
 	void update(real64_t delta);
 	void flush() const;
 public:
 	typedef bool(*event_callback_t)(const SDL_Event*);
 	static event_callback_t get_event_callback();
 	static bool_t Hitboxes, Framerate;
+private:
+	void do_census(census_t& census);
 private:
 	static bool_t Ready;
 	mutable bool_t active { false };
 	mutable bool_t amend { false };
+	bool census_window { false };
 	SDL_Window* window { nullptr };
 	SDL_GLContext context { nullptr };
 };
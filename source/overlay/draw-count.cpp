@@ -25,6 +25,7 @@ void draw_count_t::invalidate() const {
 void draw_count_t::render(renderer_t& renderer) const {
 	if (visible and !quads.empty()) {
 		auto& list = renderer.display_list(
+			display,
 			layer,
 			blend_mode_t::Alpha,
 			program_t::Sprites
@@ -2,6 +2,7 @@
 
 #include "../utility/enums.hpp"
 #include "../utility/rect.hpp"
+#include "../video/display-handle.hpp"
 #include "../video/vertex-pool.hpp"
 
 struct renderer_t;
@@ -39,6 +40,7 @@ private:
 	void generate_one(vtx_major_t* quad, const glm::vec2& pos, const glm::vec2& uvs, const glm::vec2& inv, sint_t texID);
 private:
 	mutable bool_t amend { false };
+	mutable display_handle_t display {};
 	layer_t layer { layer_value::Persistent };
 	bool_t backwards { false };
 	bool_t visible { false };
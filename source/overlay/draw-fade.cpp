@@ -49,6 +49,7 @@ void draw_fade_t::handle() {
 
 void draw_fade_t::render(renderer_t& renderer) const {
 	auto& list = renderer.display_list(
+		display,
 		layer_value::Persistent,
 		blend_mode_t::Alpha,
 		program_t::Colors
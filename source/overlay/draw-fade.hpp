@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../utility/rect.hpp"
+#include "../video/display-handle.hpp"
 
 struct renderer_t;
 
@@ -30,6 +31,7 @@ public:
 	bool is_visible() const;
 private:
 	mutable bool_t amend { false };
+	mutable display_handle_t display {};
 	fade_state_t state { fade_state_t::DoneOut };
 	rect_t bounding {};
 };
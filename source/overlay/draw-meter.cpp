@@ -39,6 +39,7 @@ void draw_meter_t::render(renderer_t& renderer) const {
 	if (current != 0) {
 		graphed.render(renderer);
 		auto& list = renderer.display_list(
+			display,
 			layer_value::Persistent,
 			blend_mode_t::Alpha,
 			program_t::Colors
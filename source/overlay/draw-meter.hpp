@@ -3,6 +3,7 @@
 #include "./draw-scheme.hpp"
 
 #include "../utility/rect.hpp"
+#include "../video/display-handle.hpp"
 
 struct draw_meter_t : public not_copyable_t {
 public:
@@ -19,6 +20,7 @@ public:
 	void set_values(sint_t current, sint_t maximum);
 private:
 	mutable bool_t amend { false };
+	mutable display_handle_t display {};
 	sint_t current { 0 };
 	rect_t varying {};
 	draw_scheme_t graphed {};
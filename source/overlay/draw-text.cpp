@@ -34,6 +34,7 @@ void draw_text_t::increment() {
 void draw_text_t::render(renderer_t& renderer) const {
 	if (font and !quads.empty()) {
 		auto& list = renderer.display_list(
+			display,
 			layer,
 			blend_mode_t::Alpha,
 			program_t::Strings
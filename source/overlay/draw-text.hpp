@@ -4,6 +4,7 @@
 
 #include "../utility/rect.hpp"
 #include "../utility/enums.hpp"
+#include "../video/display-handle.hpp"
 #include "../video/vertex-pool.hpp"
 #include "../video/gfx.hpp"
 
@@ -42,6 +43,7 @@ private:
 	void generate();
 private:
 	mutable bool_t amend { false };
+	mutable display_handle_t display {};
 	const font_t* font { nullptr };
 	glm::vec2 position {};
 	glm::vec2 origin {};
@@ -21,6 +21,7 @@ void draw_units_t::invalidate() const {
 void draw_units_t::render(renderer_t& renderer) const {
 	if (!quads.empty()) {
 		auto& list = renderer.display_list(
+			display,
 			layer_value::Persistent,
 			blend_mode_t::Alpha,
 			program_t::Sprites
@@ -2,6 +2,7 @@
 
 #include "../utility/enums.hpp"
 #include "../utility/rect.hpp"
+#include "../video/display-handle.hpp"
 #include "../video/vertex-pool.hpp"
 
 struct renderer_t;
@@ -29,6 +30,7 @@ private:
 	void generate(arch_t current, arch_t maximum, bool_t resize);
 private:
 	mutable bool_t amend { false };
+	mutable display_handle_t display {};
 	glm::vec2 position {};
 	rect_t bounding {};
 	sint_t current_value { 0 };
@@ -191,16 +191,29 @@ void animation_t::render(renderer_t& renderer, const rect_t& viewport, arch_t st
 		const glm::vec2 origin = sequences[state].get_origin(frame, variation, mirroring);
 		if (viewport.overlaps(position - origin, dimensions * scale)) {
 			const rect_t quad = sequences[state].get_quad(inverts, frame, variation);
-			auto& list = renderer.display_list(
-				layer,
-				blend_mode_t::Alpha,
-				program_t::Sprites
-			);
 			const sint_t texID = texture ? texture->get_name() : 0;
-			list.begin(display_list_t::SingleQuad)
-				.vtx_major_write(quad, dimensions, mirroring, alpha, texID)
-				.vtx_transform_write(position - origin, scale, pivot, angle)
-			.end();
+			if (renderer.has_instancing()) {
+				auto& list = renderer.display_list(
+					display,
+					layer,
+					blend_mode_t::Alpha,
+					program_t::Instances
+				);
+				list.begin(display_list_t::SingleSprite)
+					.vtx_sprite_write(quad, dimensions, mirroring, alpha, texID, position - origin, scale, pivot, angle)
+				.end();
+			} else {
+				auto& list = renderer.display_list(
+					display,
+					layer,
+					blend_mode_t::Alpha,
+					program_t::Sprites
+				);
+				list.begin(display_list_t::SingleQuad)
+					.vtx_major_write(quad, dimensions, mirroring, alpha, texID)
+					.vtx_transform_write(position - origin, scale, pivot, angle)
+				.end();
+			}
 		}
 	}
 }
@@ -212,16 +225,29 @@ void animation_t::render(renderer_t& renderer, const rect_t& viewport, arch_t st
 		const glm::vec2 origin = sequences[state].get_origin(frame, variation, mirroring);
 		if (viewport.overlaps(position - origin, dimensions * scale)) {
 			const rect_t quad = sequences[state].get_quad(inverts, frame, variation);
-			auto& list = renderer.display_list(
-				layer,
-				blend_mode_t::Alpha,
-				program_t::Sprites
-			);
 			sint_t texID = texture ? texture->get_name() : 0;
-			list.begin(display_list_t::SingleQuad)
-				.vtx_major_write(quad, dimensions, mirroring, alpha, texID)
-				.vtx_transform_write(position - origin, scale)
-			.end();
+			if (renderer.has_instancing()) {
+				auto& list = renderer.display_list(
+					display,
+					layer,
+					blend_mode_t::Alpha,
+					program_t::Instances
+				);
+				list.begin(display_list_t::SingleSprite)
+					.vtx_sprite_write(quad, dimensions, mirroring, alpha, texID, position - origin, scale, glm::zero<glm::vec2>(), 0.0f)
+				.end();
+			} else {
+				auto& list = renderer.display_list(
+					display,
+					layer,
+					blend_mode_t::Alpha,
+					program_t::Sprites
+				);
+				list.begin(display_list_t::SingleQuad)
+					.vtx_major_write(quad, dimensions, mirroring, alpha, texID)
+					.vtx_transform_write(position - origin, scale)
+				.end();
+			}
 		}
 	}
 }
@@ -230,6 +256,7 @@ void animation_t::render(renderer_t& renderer, bool_t& amend, arch_t state, arch
 	this->assure();
 	if (state < sequences.size()) {
 		auto& list = renderer.display_list(
+			persistent,
 			layer_value::Persistent,
 			blend_mode_t::Alpha,
 			program_t::Sprites
@@ -250,6 +277,59 @@ void animation_t::render(renderer_t& renderer, bool_t& amend, arch_t state, arch
 	}
 }
 
+void animation_t::render(renderer_t& renderer, const rect_t& viewport, arch_t state, layer_t layer, arch_t count, const glm::vec2* positions, const arch_t* frames, const real_t* alphas) const {
+	this->assure();
+	if (count > 0 and state < sequences.size()) {
+		const glm::vec2 dimensions = sequences[state].get_dimensions();
+		const sint_t texID = texture ? texture->get_name() : 0;
+		if (renderer.has_instancing()) {
+			// Same program as actor sprites, so both keep their submission order on a shared layer
+			auto& list = renderer.display_list(
+				display,
+				layer,
+				blend_mode_t::Alpha,
+				program_t::Instances
+			);
+			for (arch_t it = 0; it < count; ++it) {
+				const glm::vec2 origin = sequences[state].get_origin(frames[it], 0, mirroring_t::None);
+				if (viewport.overlaps(positions[it] - origin, dimensions)) {
+					const rect_t quad = sequences[state].get_quad(inverts, frames[it], 0);
+					list.begin(display_list_t::SingleSprite)
+						.vtx_sprite_write(quad, dimensions, mirroring_t::None, alphas[it], texID, positions[it] - origin, glm::one<glm::vec2>(), glm::zero<glm::vec2>(), 0.0f)
+					.end();
+				}
+			}
+			return;
+		}
+		arch_t visible = 0;
+		for (arch_t it = 0; it < count; ++it) {
+			const glm::vec2 origin = sequences[state].get_origin(frames[it], 0, mirroring_t::None);
+			if (viewport.overlaps(positions[it] - origin, dimensions)) {
+				++visible;
+			}
+		}
+		if (visible > 0) {
+			// Whole batch goes out as one run of quads
+			auto& list = renderer.display_list(
+				display,
+				layer,
+				blend_mode_t::Alpha,
+				program_t::Sprites
+			);
+			list.begin(display_list_t::SingleQuad * visible);
+			arch_t index = 0;
+			for (arch_t it = 0; it < count; ++it) {
+				const glm::vec2 origin = sequences[state].get_origin(frames[it], 0, mirroring_t::None);
+				if (viewport.overlaps(positions[it] - origin, dimensions)) {
+					const rect_t quad = sequences[state].get_quad(inverts, frames[it], 0);
+					list.vtx_batch_write(index++, quad, positions[it] - origin, dimensions, alphas[it], texID);
+				}
+			}
+			list.end();
+		}
+	}
+}
+
 void animation_t::load(const std::string& full_path) {
 	if (!sequences.empty()) {
 		synao_log("Warning! Tried to overwrite animation!\n");
@@ -7,6 +7,7 @@
 
 #include "../utility/rect.hpp"
 #include "../utility/enums.hpp"
+#include "../video/display-handle.hpp"
 
 struct thread_pool_t;
 struct texture_t;
@@ -74,6 +75,7 @@ public:
 	void render(renderer_t& renderer, const rect_t& viewport, arch_t state, arch_t frame, arch_t variation, mirroring_t mirroring, layer_t layer, real_t alpha, const glm::vec2& position, const glm::vec2& scale, real_t angle, const glm::vec2& pivot) const;
 	void render(renderer_t& renderer, const rect_t& viewport, arch_t state, arch_t frame, arch_t variation, mirroring_t mirroring, layer_t layer, real_t alpha, const glm::vec2& position, const glm::vec2& scale) const;
 	void render(renderer_t& renderer, bool_t& amend, arch_t state, arch_t frame, arch_t variation, const glm::vec2& position) const;
+	void render(renderer_t& renderer, const rect_t& viewport, arch_t state, layer_t layer, arch_t count, const glm::vec2* positions, const arch_t* frames, const real_t* alphas) const;
 	void load(const std::string& full_path);
 	void load(const std::string& full_path, thread_pool_t& thread_pool);
 	void assure() const;
@@ -86,4 +88,6 @@ private:
 	std::vector<animation_sequence_t> sequences {};
 	glm::vec2 inverts { 1.0f };
 	const texture_t* texture { nullptr };
+	mutable display_handle_t display {};
+	mutable display_handle_t persistent {};
 };
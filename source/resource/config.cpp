@@ -11,7 +11,9 @@ void config_t::generate(const std::string& path) {
 	data.clear();
 
 	this->set_meta_menu(false);
+	this->set_practice(false);
 	this->set_legacy_gl(false);
+	this->set_multithreaded(true);
 	this->set_language("english");
 
 	this->set_vertical_sync(false);
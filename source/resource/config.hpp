@@ -32,6 +32,22 @@ public:
 			data["Setup"]["MetaMenu"] = value;
 		}
 	}
+	bool get_practice() const {
+		if (
+			valid and
+			data.contains("Setup") and
+			data["Setup"].contains("Practice") and
+			data["Setup"]["Practice"].is_boolean()
+		) {
+			return data["Setup"]["Practice"].get<bool>();
+		}
+		return false;
+	}
+	void set_practice(bool value) {
+		if (valid) {
+			data["Setup"]["Practice"] = value;
+		}
+	}
 	bool get_legacy_gl() const {
 		if (
 			valid and
@@ -48,6 +64,22 @@ public:
 			data["Setup"]["LegacyGL"] = value;
 		}
 	}
+	bool get_multithreaded() const {
+		if (
+			valid and
+			data.contains("Setup") and
+			data["Setup"].contains("Multithreaded") and
+			data["Setup"]["Multithreaded"].is_boolean()
+		) {
+			return data["Setup"]["Multithreaded"].get<bool>();
+		}
+		return true;
+	}
+	void set_multithreaded(bool value) {
+		if (valid) {
+			data["Setup"]["Multithreaded"] = value;
+		}
+	}
 	std::string get_language() const {
 		if (
 			valid and
@@ -262,6 +294,22 @@ public:
 			data["Input"]["Macro"] = value;
 		}
 	}
+	real64_t get_macro_seek() const {
+		if (
+			valid and
+			data.contains("Input") and
+			data["Input"].contains("Seek") and
+			data["Input"]["Seek"].is_number()
+		) {
+			return data["Input"]["Seek"].get<real64_t>();
+		}
+		return 0.0;
+	}
+	void set_macro_seek(real64_t value) {
+		if (valid) {
+			data["Input"]["Seek"] = value;
+		}
+	}
 	bool get_playback() const {
 		if (
 			valid and
@@ -162,6 +162,89 @@ void main() {
 	vs.table = table;
 })";
 
+static constexpr byte_t kTilesVert420[] = R"(
+layout(binding = 0, std140) uniform transforms {
+	mat4 viewports[2];
+};
+layout(location = 0) in vec2 position;
+layout(location = 1) in int matrix;
+layout(location = 2) in vec2 uvcoords;
+layout(location = 3) in int texID;
+layout(location = 4) in int index;
+out STAGE {
+	layout(location = 0) vec2 uvcoords;
+	layout(location = 1) flat int texID;
+	layout(location = 2) flat int index;
+} vs;
+out gl_PerVertex {
+	vec4 gl_Position;
+	float gl_PointSize;
+	float gl_ClipDistance[];
+};
+void main() {
+	gl_Position = viewports[matrix] * vec4(position, 0.0f, 1.0f);
+	vs.uvcoords = uvcoords;
+	vs.texID = texID;
+	vs.index = index;
+})";
+
+static constexpr byte_t kTilesVert330[] = R"(
+layout(std140) uniform transforms {
+	mat4 viewports[2];
+};
+layout(location = 0) in vec2 position;
+layout(location = 1) in int matrix;
+layout(location = 2) in vec2 uvcoords;
+layout(location = 3) in int texID;
+layout(location = 4) in int index;
+out STAGE {
+	vec2 uvcoords;
+	flat int texID;
+	flat int index;
+} vs;
+void main() {
+	gl_Position = viewports[matrix] * vec4(position, 0.0f, 1.0f);
+	vs.uvcoords = uvcoords;
+	vs.texID = texID;
+	vs.index = index;
+})";
+
+// Base instances are a 4.2 feature, so there's no 330 variant
+static constexpr byte_t kSpriteVert420[] = R"(
+layout(binding = 0, std140) uniform transforms {
+	mat4 viewports[2];
+};
+layout(location = 0) in vec4 bounds;
+layout(location = 1) in vec4 uvcoords;
+layout(location = 2) in vec4 transform;
+layout(location = 3) in vec2 effects;
+layout(location = 4) in ivec3 indices;
+out STAGE {
+	layout(location = 0) vec2 uvcoords;
+	layout(location = 1) float alpha;
+	layout(location = 2) flat int texID;
+} vs;
+out gl_PerVertex {
+	vec4 gl_Position;
+	float gl_PointSize;
+	float gl_ClipDistance[];
+};
+void main() {
+	vec2 corner = vec2(float(gl_VertexID >> 1), float(gl_VertexID & 1));
+	vec2 local = corner * bounds.zw * transform.xy - transform.zw;
+	float c = cos(effects.x);
+	float s = sin(effects.x);
+	vec2 position = bounds.xy + transform.zw + vec2(
+		local.x * c - local.y * s,
+		local.x * s + local.y * c
+	);
+	vec2 mirror = vec2(float(indices.z & 1), float((indices.z >> 1) & 1));
+	gl_Position = viewports[indices.x] * vec4(position, 0.0f, 1.0f);
+	vs.uvcoords = mix(uvcoords.xy, uvcoords.zw, abs(mirror - corner));
+	vs.alpha = effects.y;
+	vs.texID = indices.y;
+})";
+
 static constexpr byte_t kColorsFrag420[] = R"(
 in STAGE {
 	layout(location = 0) vec4 color;
@@ -236,6 +319,84 @@ void main() {
 	fragment = color * fs.color;
 })";
 
+static constexpr byte_t kIndexedFrag420[] = R"(
+layout(binding = 0) uniform sampler2DArray diffuse;
+layout(binding = 2) uniform usampler2DArray indices;
+in STAGE {
+	layout(location = 0) vec2 uvcoords;
+	layout(location = 1) flat int texID;
+	layout(location = 2) flat int index;
+} fs;
+layout(location = 0) out vec4 fragment;
+void main() {
+	uint type = texelFetch(indices, ivec3(floor(fs.uvcoords), fs.index), 0).r;
+	if (type == 0u) {
+		discard;
+	}
+	int tile = int(type) - 1;
+	vec2 texels = (vec2(tile % 16, tile / 16) + fract(fs.uvcoords)) * 16.0f;
+	vec2 inverse = 1.0f / vec2(textureSize(diffuse, 0).xy);
+	fragment = textureLod(diffuse, vec3(texels * inverse, float(fs.texID)), 0.0f);
+})";
+
+static constexpr byte_t kIndexedFrag330[] = R"(
+uniform sampler2DArray diffuse;
+uniform usampler2DArray indices;
+in STAGE {
+	vec2 uvcoords;
+	flat int texID;
+	flat int index;
+} fs;
+layout(location = 0) out vec4 fragment;
+void main() {
+	uint type = texelFetch(indices, ivec3(floor(fs.uvcoords), fs.index), 0).r;
+	if (type == 0u) {
+		discard;
+	}
+	int tile = int(type) - 1;
+	vec2 texels = (vec2(tile % 16, tile / 16) + fract(fs.uvcoords)) * 16.0f;
+	vec2 inverse = 1.0f / vec2(textureSize(diffuse, 0).xy);
+	fragment = textureLod(diffuse, vec3(texels * inverse, float(fs.texID)), 0.0f);
+})";
+
+static constexpr byte_t kParallaxFrag420[] = R"(
+layout(binding = 0) uniform sampler2DArray diffuse;
+layout(binding = 1, std140) uniform parallaxes {
+	vec4 parameters[32];
+};
+in STAGE {
+	layout(location = 0) vec2 uvcoords;
+	layout(location = 1) flat int texID;
+	layout(location = 2) flat int index;
+} fs;
+layout(location = 0) out vec4 fragment;
+void main() {
+	vec4 bounding = parameters[fs.index * 2];
+	vec4 scrolling = parameters[fs.index * 2 + 1];
+	vec2 cycle = fract((fs.uvcoords - scrolling.xy) / scrolling.zw);
+	vec2 texels = bounding.xy + cycle * bounding.zw;
+	fragment = textureLod(diffuse, vec3(texels, float(fs.texID)), 0.0f);
+})";
+
+static constexpr byte_t kParallaxFrag330[] = R"(
+uniform sampler2DArray diffuse;
+layout(std140) uniform parallaxes {
+	vec4 parameters[32];
+};
+in STAGE {
+	vec2 uvcoords;
+	flat int texID;
+	flat int index;
+} fs;
+layout(location = 0) out vec4 fragment;
+void main() {
+	vec4 bounding = parameters[fs.index * 2];
+	vec4 scrolling = parameters[fs.index * 2 + 1];
+	vec2 cycle = fract((fs.uvcoords - scrolling.xy) / scrolling.zw);
+	vec2 texels = bounding.xy + cycle * bounding.zw;
+	fragment = textureLod(diffuse, vec3(texels, float(fs.texID)), 0.0f);
+})";
+
 namespace program {
 	std::string directive() {
 		return fmt::format(
@@ -280,6 +441,20 @@ namespace program {
 		}
 		return result;
 	}
+	std::string tiles_vert() {
+		std::string result = program::directive();
+		if (opengl_version[0] == 4 and opengl_version[1] >= 2) {
+			result += kTilesVert420;
+		} else {
+			result += kTilesVert330;
+		}
+		return result;
+	}
+	std::string sprite_vert() {
+		std::string result = program::directive();
+		result += kSpriteVert420;
+		return result;
+	}
 	std::string colors_frag() {
 		std::string result = program::directive();
 		if (opengl_version[0] == 4 and opengl_version[1] >= 2) {
@@ -307,4 +482,22 @@ namespace program {
 		}
 		return result;
 	}
+	std::string indexed_frag() {
+		std::string result = program::directive();
+		if (opengl_version[0] == 4 and opengl_version[1] >= 2) {
+			result += kIndexedFrag420;
+		} else {
+			result += kIndexedFrag330;
+		}
+		return result;
+	}
+	std::string parallax_frag() {
+		std::string result = program::directive();
+		if (opengl_version[0] == 4 and opengl_version[1] >= 2) {
+			result += kParallaxFrag420;
+		} else {
+			result += kParallaxFrag330;
+		}
+		return result;
+	}
 }
@@ -6,9 +6,12 @@
 
 namespace __enum_program {
 	enum type : arch_t {
-		Colors,  // Blank + Colors
-		Sprites, // Major + Sprites
-		Strings, // Fonts + Channels
+		Colors,   // Blank + Colors
+		Parallax, // Tiles + Parallax (sorts before tile programs)
+		Instances, // Sprite + Sprites (needs base instances, sorts before quads like actors were submitted)
+		Sprites,  // Major + Sprites
+		Strings,  // Fonts + Channels
+		Tilemap,  // Tiles + Indexed
 		Total
 	};
 }
@@ -21,7 +24,11 @@ namespace program {
 	std::string blank_vert();
 	std::string major_vert();
 	std::string fonts_vert();
+	std::string tiles_vert();
+	std::string sprite_vert();
 	std::string colors_frag();
 	std::string sprites_frag();
 	std::string channels_frag();
+	std::string indexed_frag();
+	std::string parallax_frag();
 }
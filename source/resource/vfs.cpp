@@ -120,10 +120,14 @@ bool vfs_t::init(const config_t& config) {
 	}
 
 	// Setup Thread Pool
-	if (!vfs_t::device->thread_pool.init(kTotalThreads)) {
+	// Leave a core to the main thread on machines with more than the minimum
+	const arch_t hardware = std::thread::hardware_concurrency();
+	const arch_t threads = hardware > kTotalThreads + 1 ? hardware - 1 : kTotalThreads;
+	if (!vfs_t::device->thread_pool.init(threads)) {
 		synao_log("Error! Couldn't create thread pool!\n");
 		return false;
 	}
+	vfs_t::device->simulation_threads = config.get_multithreaded();
 
 	// Setup Filesystem
 	vfs_t::device->personal = vfs_t::personal_directory();
@@ -205,18 +209,6 @@ bool vfs_t::create_directory(const std::string& name) {
 	return true;
 }
 
-bool vfs_t::create_recording(const std::string& path, const std::vector<uint16_t>& buffer, sint64_t seed) {
-	std::ofstream ofs { path, std::ios::binary };
-	if (ofs.is_open()) {
-		arch_t length = buffer.size() * sizeof(uint16_t);
-		ofs.write(reinterpret_cast<const byte_t*>(&seed), sizeof(sint64_t));
-		ofs.write(reinterpret_cast<const byte_t*>(buffer.data()), length);
-		return true;
-	}
-	synao_log("Failed to write file: {}!\n", path);
-	return false;
-}
-
 std::string vfs_t::working_directory() {
 	std::error_code code;
 	auto path = fs::current_path(code);
@@ -346,26 +338,6 @@ std::vector<uint_t> vfs_t::uint32_buffer(const std::string& path) {
 	return {};
 }
 
-bool vfs_t::record_buffer(const std::string& path, std::vector<uint16_t>& buffer, sint64_t& seed) {
-	std::ifstream ifs { path, std::ios::binary };
-	if (ifs.is_open()) {
-		ifs.seekg(0, std::ios::end);
-		arch_t length = static_cast<arch_t>(ifs.tellg());
-		if (length > 0 and ((length / sizeof(uint16_t)) > sizeof(sint64_t))) {
-			ifs.seekg(0, std::ios::beg);
-			buffer.resize(
-				(length / sizeof(uint16_t)) -
-				sizeof(sint64_t)
-			);
-			ifs.read(reinterpret_cast<byte_t*>(&seed), sizeof(sint64_t));
-			ifs.read(reinterpret_cast<byte_t*>(buffer.data()), length);
-			return true;
-		}
-	}
-	synao_log("Failed to open file: {}!\n", path);
-	return false;
-}
-
 std::string vfs_t::i18n_find(const std::string& segment, arch_t index) {
 	if (!vfs_t::device) {
 		return {};
@@ -441,17 +413,16 @@ const texture_t* vfs_t::texture(const std::string& name) {
 	if (!vfs_t::device->sampler_allocator) {
 		return nullptr;
 	}
-	auto it = vfs_t::device->search_safely(name, vfs_t::device->textures);
-	if (it == vfs_t::device->textures.end()) {
-		texture_t& ref = vfs_t::device->emplace_safely(name, vfs_t::device->textures);
-		ref.load(
+	auto [ref, inserted] = vfs_t::device->acquire_safely(name, vfs_t::device->textures);
+	if (inserted) {
+		ref->load(
 			kImagePath + name + ".png",
 			vfs_t::device->sampler_allocator,
 			vfs_t::device->thread_pool
 		);
-		return &ref;
+		vfs_t::device->publish_safely(ref);
 	}
-	return &it->second;
+	return ref;
 }
 
 const atlas_t* vfs_t::atlas(const std::string& name) {
@@ -461,17 +432,16 @@ const atlas_t* vfs_t::atlas(const std::string& name) {
 	if (!vfs_t::device->sampler_allocator) {
 		return nullptr;
 	}
-	auto it = vfs_t::device->search_safely(name, vfs_t::device->atlases);
-	if (it == vfs_t::device->atlases.end()) {
-		atlas_t& ref = vfs_t::device->emplace_safely(name, vfs_t::device->atlases);
-		ref.load(
+	auto [ref, inserted] = vfs_t::device->acquire_safely(name, vfs_t::device->atlases);
+	if (inserted) {
+		ref->load(
 			kFontPath + name + ".png",
 			vfs_t::device->sampler_allocator,
 			vfs_t::device->thread_pool
 		);
-		return &ref;
+		vfs_t::device->publish_safely(ref);
 	}
-	return &it->second;
+	return ref;
 }
 
 const shader_t* vfs_t::shader(const std::string& name, const std::string& source, shader_stage_t stage) {
@@ -513,26 +483,29 @@ const noise_t* vfs_t::noise(const entt::hashed_string& entry) {
 	if (!vfs_t::device) {
 		return nullptr;
 	}
-	auto it = vfs_t::device->search_safely(entry.value(), vfs_t::device->noises);
-	if (it == vfs_t::device->noises.end()) {
-		noise_t& ref = vfs_t::device->emplace_safely(entry.value(), vfs_t::device->noises);
-		ref.load(kNoisePath + std::string(entry.data()) + ".wav", vfs_t::device->thread_pool);
-		return &ref;
+	auto [ref, inserted] = vfs_t::device->acquire_safely(entry.value(), vfs_t::device->noises);
+	if (inserted) {
+		ref->load(kNoisePath + std::string(entry.data()) + ".wav", vfs_t::device->thread_pool);
+		vfs_t::device->publish_safely(ref);
 	}
-	return &it->second;
+	return ref;
 }
 
 const animation_t* vfs_t::animation(const entt::hashed_string& entry) {
 	if (!vfs_t::device) {
 		return nullptr;
 	}
-	auto it = vfs_t::device->search_safely(entry.value(), vfs_t::device->animations);
-	if (it == vfs_t::device->animations.end()) {
-		animation_t& ref = vfs_t::device->emplace_safely(entry.value(), vfs_t::device->animations);
-		ref.load(kSpritePath + std::string(entry.data()) + ".json", vfs_t::device->thread_pool);
-		return &ref;
+	auto [ref, inserted] = vfs_t::device->acquire_safely(entry.value(), vfs_t::device->animations);
+	if (inserted) {
+		// Snapshots store sprites by name, since pointers don't survive a restart
+		{
+			std::lock_guard<std::mutex> lock{vfs_t::device->storage_mutex};
+			vfs_t::device->animation_names.try_emplace(ref, entry.data());
+		}
+		ref->load(kSpritePath + std::string(entry.data()) + ".json", vfs_t::device->thread_pool);
+		vfs_t::device->publish_safely(ref);
 	}
-	return &it->second;
+	return ref;
 }
 
 const animation_t* vfs_t::animation(const std::string& name) {
@@ -540,6 +513,17 @@ const animation_t* vfs_t::animation(const std::string& name) {
 	return vfs_t::animation(entry);
 }
 
+std::string vfs_t::animation_name(const animation_t* file) {
+	if (!vfs_t::device or !file) {
+		return std::string();
+	}
+	const std::string* name = vfs_t::device->search_safely(file, vfs_t::device->animation_names);
+	if (!name) {
+		return std::string();
+	}
+	return *name;
+}
+
 const font_t* vfs_t::font(const std::string& name) {
 	if (!vfs_t::device) {
 		return nullptr;
@@ -567,3 +551,17 @@ const font_t* vfs_t::font(arch_t index) {
 const font_t* vfs_t::debug_font() {
 	return vfs_t::font(kDebugFontIndex);
 }
+
+thread_pool_t* vfs_t::workers() {
+	if (!vfs_t::device) {
+		return nullptr;
+	}
+	return &vfs_t::device->thread_pool;
+}
+
+bool vfs_t::multithreaded() {
+	if (!vfs_t::device) {
+		return false;
+	}
+	return vfs_t::device->simulation_threads;
+}
@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
 #include <entt/core/hashed_string.hpp>
 
 #include "./animation.hpp"
@@ -35,7 +37,6 @@ public:
 	static bool directory_exists(const std::string& name, bool_t print = true);
 	static bool file_exists(const std::string& name, bool_t print = true);
 	static bool create_directory(const std::string& name);
-	static bool create_recording(const std::string& path, const std::vector<uint16_t>& buffer, sint64_t seed);
 	static std::string working_directory();
 	static std::string executable_directory();
 	static std::string personal_directory();
@@ -44,7 +45,6 @@ public:
 	static std::string string_buffer(const std::string& path);
 	static std::vector<byte_t> byte_buffer(const std::string& path);
 	static std::vector<uint_t> uint32_buffer(const std::string& path);
-	static bool record_buffer(const std::string& path, std::vector<uint16_t>& buffer, sint64_t& seed);
 	static std::string i18n_find(const std::string& segment, arch_t index);
 	static std::string i18n_find(const std::string& segment, arch_t first, arch_t last);
 	static arch_t i18n_size(const std::string& segment);
@@ -57,25 +57,55 @@ public:
 	static const noise_t* noise(const entt::hashed_string& entry);
 	static const animation_t* animation(const std::string& name);
 	static const animation_t* animation(const entt::hashed_string& entry);
+	static std::string animation_name(const animation_t* file);
 	static const font_t* font(const std::string& name);
 	static const font_t* font(arch_t index);
 	static const font_t* debug_font();
+	static thread_pool_t* workers();
+	static bool multithreaded();
 private:
+	// Looks up and inserts under one lock, so when several runtimes ask for
+	// the same asset at once only the caller that inserted it loads it. The
+	// others wait until that caller publishes the entry
 	template<typename K, typename T>
-	T& emplace_safely(const K& key, std::unordered_map<K, T>& map) {
-		std::lock_guard<std::mutex> lock{this->storage_mutex};
+	std::pair<T*, bool> acquire_safely(const K& key, std::unordered_map<K, T>& map) {
+		std::unique_lock<std::mutex> lock{this->storage_mutex};
 		auto result = map.try_emplace(key);
-		return result.first->second;
+		T* ref = &result.first->second;
+		if (result.second) {
+			loading.insert(ref);
+		} else {
+			storage_ready.wait(lock, [this, ref] {
+				return loading.find(ref) == loading.end();
+			});
+		}
+		return std::make_pair(ref, result.second);
+	}
+	void publish_safely(const void* ref) {
+		{
+			std::lock_guard<std::mutex> lock{this->storage_mutex};
+			loading.erase(ref);
+		}
+		storage_ready.notify_all();
 	}
 	template<typename K, typename T>
-	auto search_safely(const K& key, const std::unordered_map<K, T>& map) {
+	const T* search_safely(const K& key, const std::unordered_map<K, T>& map) {
 		std::lock_guard<std::mutex> lock{this->storage_mutex};
-		return map.find(key);
+		auto iter = map.find(key);
+		if (iter == map.end()) {
+			return nullptr;
+		}
+		return &iter->second;
 	}
 private:
+	// Shared by every runtime in the process. Assets are loaded once
+	// and only read afterwards, so runtimes never hold copies of their own.
 	static vfs_t* device;
 	thread_pool_t thread_pool {};
+	bool_t simulation_threads { true };
 	std::mutex storage_mutex {};
+	std::condition_variable storage_ready {};
+	std::unordered_set<const void*> loading {};
 	std::string personal {};
 	std::string language {};
 	sampler_allocator_t* sampler_allocator { nullptr };
@@ -85,5 +115,6 @@ private:
 	std::unordered_map<std::string, shader_t> shaders {};
 	std::unordered_map<entt::id_type, noise_t> noises {};
 	std::unordered_map<entt::id_type, animation_t> animations {};
+	std::unordered_map<const animation_t*, std::string> animation_names {};
 	std::unordered_map<std::string, font_t> fonts {};
 };
@@ -2,9 +2,13 @@
 
 #include "../resource/config.hpp"
 #include "../resource/vfs.hpp"
+#include "../utility/constants.hpp"
 #include "../utility/logger.hpp"
 #include "../utility/rng.hpp"
+#include "./snapshot.hpp"
 
+#include <cstring>
+#include <algorithm>
 #include <functional>
 #include <glm/gtc/constants.hpp>
 #include <SDL2/SDL_scancode.h>
@@ -15,6 +19,44 @@ namespace {
 	constexpr sint_t kScancodeNothing  = -1;
 	constexpr sint_t kScancodeKeyboard = -2;
 	constexpr sint_t kScancodeJoystick = -3;
+
+	// Header, then chunks, then an index of every chunk and a trailer pointing at it
+	constexpr byte_t kMacroMagic[] 		= "LRM4";
+	constexpr byte_t kMacroUnstamped[] 	= "LRM3";
+	// Every chunked layout starts with this, and older ones can't be read anymore
+	constexpr byte_t kMacroFamily[] 	= "LRM";
+	constexpr byte_t kMacroIndexTag[] 	= "LRMX";
+	constexpr arch_t kMacroMagicSize 	= sizeof(kMacroMagic) - 1;
+	constexpr arch_t kMacroHeaderSize 	= kMacroMagicSize + sizeof(sint64_t) + sizeof(uint64_t);
+	// Same layout without the build id, so its inputs play but its keyframes never load
+	constexpr arch_t kMacroUnstampedSize = kMacroMagicSize + sizeof(sint64_t);
+	constexpr arch_t kMacroChunkSize 	= sizeof(uint8_t) + sizeof(uint64_t) * 3;
+	constexpr arch_t kMacroEntrySize 	= sizeof(uint8_t) + sizeof(uint64_t) * 4;
+	constexpr arch_t kMacroTrailerSize 	= sizeof(uint64_t) * 2 + kMacroMagicSize;
+	constexpr uint8_t kMacroButtons 	= 'B';
+	constexpr uint8_t kMacroKeyframe 	= 'K';
+
+	void write_varint(std::vector<byte_t>& output, arch_t value) {
+		while (value >= 0x80) {
+			output.push_back(static_cast<byte_t>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		output.push_back(static_cast<byte_t>(value));
+	}
+
+	bool read_varint(const std::vector<byte_t>& input, arch_t& index, arch_t& value) {
+		value = 0;
+		arch_t shift = 0;
+		while (index < input.size() and shift < sizeof(arch_t) * 8) {
+			const arch_t data = static_cast<uint8_t>(input[index++]);
+			value |= (data & 0x7F) << shift;
+			if (!(data & 0x80)) {
+				return true;
+			}
+			shift += 7;
+		}
+		return false;
+	}
 }
 
 #ifdef LEVIATHAN_USES_META
@@ -53,10 +95,9 @@ bool input_t::init(const config_t& config) {
 	return true;
 }
 
-bool input_t::save(const config_t& config) {
+bool input_t::save(const config_t&) {
 	if (player and player->recording()) {
-		const std::string macro = config.get_macro_file();
-		if (!player->write(macro)) {
+		if (!player->finish()) {
 			return false;
 		}
 		player.reset();
@@ -275,6 +316,33 @@ void input_t::advance() {
 	}
 }
 
+bool input_t::keyframe_due() const {
+	return player and player->keyframe_due();
+}
+
+void input_t::store_keyframe(const std::vector<byte_t>& data) {
+	if (player) {
+		player->store_keyframe(data);
+	}
+}
+
+void input_t::seek_keyframe(sint_t step) {
+	if (player) {
+		player->seek_keyframe(step);
+	}
+}
+
+const std::vector<byte_t>* input_t::resolve_seek() {
+	if (player) {
+		return player->resolve_seek();
+	}
+	return nullptr;
+}
+
+bool input_t::fast_forwarding() const {
+	return player and player->fast_forwarding();
+}
+
 void input_t::flush() {
 	pressed.reset();
 #ifdef LEVIATHAN_USES_META
@@ -449,78 +517,404 @@ void input_t::all_macrofile_settings(const config_t& config) {
 	if (!macro.empty()) {
 		player = std::make_unique<macro_player_t>(!playback);
 		if (!playback) {
-			synao_log("Recording inputs into macro: \"{}\"...\n", macro);
+			if (player->open(macro)) {
+				synao_log("Recording inputs into macro: \"{}\"...\n", macro);
+			} else {
+				player.reset();
+			}
 		} else if (player->load(macro)) {
 			synao_log("Playing inputs from macro: \"{}\"...\n", macro);
+			const real64_t seek = config.get_macro_seek();
+			if (seek > 0.0) {
+				player->seek(static_cast<arch_t>(seek / constants::MinInterval()));
+			}
 		} else {
 			player.reset();
 		}
 	}
 }
 
+bool macro_player_t::open(const std::string& name) {
+	const std::string path = vfs_t::resource_path(vfs_resource_path_t::Init) + name + ".macro";
+	ofs.open(path, std::ios::binary | std::ios::trunc);
+	if (!ofs.is_open()) {
+		synao_log("Error! Failed to create macro file: {}!\n", path);
+		return false;
+	}
+	const sint64_t seed = rng::seed();
+	const uint64_t build = snapshot::build_id();
+	ofs.write(kMacroMagic, kMacroMagicSize);
+	ofs.write(reinterpret_cast<const byte_t*>(&seed), sizeof(sint64_t));
+	ofs.write(reinterpret_cast<const byte_t*>(&build), sizeof(uint64_t));
+	ofs.flush();
+	buttons.reserve(kChunkTicks * 2);
+	position = 0;
+	first = 0;
+	ready = true;
+	return ofs.good();
+}
+
 bool macro_player_t::load(const std::string& name) {
-	std::vector<uint16_t> buffer {};
+	const std::string path = vfs_t::resource_path(vfs_resource_path_t::Init) + name + ".macro";
+	ifs.open(path, std::ios::binary);
+	if (!ifs.is_open()) {
+		synao_log("Error! Failed to load macro file: {}!\n", path);
+		return false;
+	}
+	ifs.seekg(0, std::ios::end);
+	const arch_t length = static_cast<arch_t>(ifs.tellg());
+	ifs.seekg(0, std::ios::beg);
+	byte_t magic[kMacroMagicSize] = {};
 	sint64_t seed = 0;
-	if (!vfs_t::record_buffer(vfs_t::resource_path(vfs_resource_path_t::Init) + name + ".macro", buffer, seed)) {
-		synao_log("Error! Failed to load macro file!\n");
+	uint64_t build = 0;
+	arch_t header = 0;
+	if (length >= kMacroUnstampedSize) {
+		ifs.read(magic, kMacroMagicSize);
+		ifs.read(reinterpret_cast<byte_t*>(&seed), sizeof(sint64_t));
+		if (length >= kMacroHeaderSize and std::memcmp(magic, kMacroMagic, kMacroMagicSize) == 0) {
+			ifs.read(reinterpret_cast<byte_t*>(&build), sizeof(uint64_t));
+			header = kMacroHeaderSize;
+		} else if (std::memcmp(magic, kMacroUnstamped, kMacroMagicSize) == 0) {
+			header = kMacroUnstampedSize;
+		}
+	}
+	chunks.clear();
+	buttons.clear();
+	if (header == 0 and length >= kMacroMagicSize and std::memcmp(magic, kMacroFamily, sizeof(kMacroFamily) - 1) == 0) {
+		synao_log("Error! Macro file uses the unsupported \"{}\" layout!\n", std::string(magic, kMacroMagicSize));
+		ifs.close();
 		return false;
 	}
-	buttons.resize(buffer.size());
-	for (arch_t it = 0; it < buttons.size(); ++it) {
-		buttons[it] = std::bitset<btn_t::Total>(static_cast<arch_t>(buffer[it]));
+	if (header != 0) {
+		// Use the index when the recording was finished, otherwise walk the chunks
+		bool_t indexed = false;
+		if (length >= header + kMacroTrailerSize) {
+			uint64_t count = 0;
+			uint64_t offset = 0;
+			byte_t tag[kMacroMagicSize] = {};
+			ifs.seekg(length - kMacroTrailerSize, std::ios::beg);
+			ifs.read(reinterpret_cast<byte_t*>(&count), sizeof(uint64_t));
+			ifs.read(reinterpret_cast<byte_t*>(&offset), sizeof(uint64_t));
+			ifs.read(tag, kMacroMagicSize);
+			if (
+				ifs.good() and
+				std::memcmp(tag, kMacroIndexTag, kMacroMagicSize) == 0 and
+				offset + count * kMacroEntrySize + kMacroTrailerSize == length
+			) {
+				ifs.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+				for (uint64_t it = 0; it < count; ++it) {
+					macro_chunk_t chunk {};
+					uint64_t literal[4] = {};
+					ifs.read(reinterpret_cast<byte_t*>(&chunk.type), sizeof(uint8_t));
+					ifs.read(reinterpret_cast<byte_t*>(literal), sizeof(literal));
+					chunk.tick = static_cast<arch_t>(literal[0]);
+					chunk.count = static_cast<arch_t>(literal[1]);
+					chunk.offset = static_cast<arch_t>(literal[2]);
+					chunk.size = static_cast<arch_t>(literal[3]);
+					chunks.push_back(chunk);
+				}
+				indexed = ifs.good();
+			}
+		}
+		if (!indexed) {
+			synao_log("Macro file has no index, so it's being scanned instead.\n");
+			ifs.clear();
+			chunks.clear();
+			this->scan(header, length);
+		}
+		if (build != snapshot::build_id()) {
+			const auto keyframes = std::remove_if(chunks.begin(), chunks.end(), [](const macro_chunk_t& chunk) {
+				return chunk.type == kMacroKeyframe;
+			});
+			if (keyframes != chunks.end()) {
+				synao_log("Macro keyframes came from another build, so seeking backwards is disabled.\n");
+				chunks.erase(keyframes, chunks.end());
+			}
+		}
+		total = 0;
+		for (auto&& chunk : chunks) {
+			if (chunk.type == kMacroButtons) {
+				total = std::max(total, chunk.tick + chunk.count);
+			}
+		}
+	} else if (length > sizeof(sint64_t)) {
+		// Headerless recordings from before chunking are a seed followed by every tick
+		ifs.seekg(0, std::ios::beg);
+		ifs.read(reinterpret_cast<byte_t*>(&seed), sizeof(sint64_t));
+		buttons.resize((length - sizeof(sint64_t)) / sizeof(uint16_t));
+		ifs.read(reinterpret_cast<byte_t*>(buttons.data()), buttons.size() * sizeof(uint16_t));
+		total = buttons.size() / 2;
+	} else {
+		synao_log("Error! Macro file is empty!\n");
+		return false;
 	}
 	rng::seed(seed);
-	index = 0;
+	position = 0;
+	first = 0;
+	ready = true;
 	return true;
 }
 
-bool macro_player_t::write(const std::string& name) {
+bool macro_player_t::finish() {
 	if (!record) {
 		return true;
 	}
-	const std::string path = vfs_t::resource_path(vfs_resource_path_t::Init) + name + ".macro";
-	std::vector<uint16_t> buffer;
-	buffer.resize(buttons.size());
-	for (arch_t it = 0; it < buttons.size(); ++it) {
-		buffer[it] = static_cast<uint16_t>(buttons[it].to_ulong());
-	}
-	sint64_t seed = rng::seed();
-	if (!vfs_t::create_recording(path, buffer, seed)) {
-		synao_log("Error! Failed to save macro file!\n");
+	record = false;
+	ready = false;
+	if (!this->flush()) {
 		return false;
 	}
+	const uint64_t offset = static_cast<uint64_t>(ofs.tellp());
+	const uint64_t count = chunks.size();
+	for (auto&& chunk : chunks) {
+		const uint64_t literal[4] = {
+			chunk.tick,
+			chunk.count,
+			chunk.offset,
+			chunk.size
+		};
+		ofs.write(reinterpret_cast<const byte_t*>(&chunk.type), sizeof(uint8_t));
+		ofs.write(reinterpret_cast<const byte_t*>(literal), sizeof(literal));
+	}
+	ofs.write(reinterpret_cast<const byte_t*>(&count), sizeof(uint64_t));
+	ofs.write(reinterpret_cast<const byte_t*>(&offset), sizeof(uint64_t));
+	ofs.write(kMacroIndexTag, kMacroMagicSize);
+	ofs.close();
+	chunks.clear();
 	buttons.clear();
-	record = false;
+	if (ofs.fail()) {
+		synao_log("Error! Failed to finish macro file!\n");
+		return false;
+	}
 	return true;
 }
 
 void macro_player_t::read(std::bitset<btn_t::Total>& pressed, std::bitset<btn_t::Total>& holding) {
 	if (this->playing()) {
-		pressed = buttons[index++];
-		holding = buttons[index++];
+		if (position < first or position >= first + buttons.size() / 2) {
+			if (!this->fetch(position)) {
+				// Treat the rest of the recording as missing
+				total = position;
+				return;
+			}
+		}
+		const arch_t index = (position - first) * 2;
+		pressed = std::bitset<btn_t::Total>(static_cast<arch_t>(buttons[index]));
+		holding = std::bitset<btn_t::Total>(static_cast<arch_t>(buttons[index + 1]));
+		++position;
 	}
 }
 
 void macro_player_t::store(const std::bitset<btn_t::Total>& pressed, const std::bitset<btn_t::Total>& holding) {
 	if (this->recording()) {
-		buttons.push_back(pressed);
-		buttons.push_back(holding);
+		buttons.push_back(static_cast<uint16_t>(pressed.to_ulong()));
+		buttons.push_back(static_cast<uint16_t>(holding.to_ulong()));
+		++position;
+		if (buttons.size() >= kChunkTicks * 2) {
+			this->flush();
+		}
 	}
 }
 
 bool macro_player_t::recording() const {
-	return record;
+	return record and ready;
 }
 
 bool macro_player_t::playing() const {
-	if (record) {
-		return false;
+	return !record and ready and position < total;
+}
+
+bool macro_player_t::keyframe_due() const {
+	return this->recording() and position >= last_keyframe + kKeyframeInterval;
+}
+
+void macro_player_t::store_keyframe(const std::vector<byte_t>& data) {
+	if (this->recording() and this->append(kMacroKeyframe, position, 0, data)) {
+		last_keyframe = position;
 	}
-	if (index == kNotReady) {
-		return false;
+}
+
+void macro_player_t::seek(arch_t tick) {
+	if (!record and ready) {
+		target = tick;
+	}
+}
+
+void macro_player_t::seek_keyframe(sint_t step) {
+	if (step > 0) {
+		for (auto&& chunk : chunks) {
+			if (chunk.type == kMacroKeyframe and chunk.tick > position) {
+				this->seek(chunk.tick);
+				return;
+			}
+		}
+	} else if (step < 0) {
+		// Like a media player, stepping back shortly after a keyframe skips past it
+		const arch_t grace = static_cast<arch_t>(1.0 / constants::MinInterval());
+		for (auto iter = chunks.rbegin(); iter != chunks.rend(); ++iter) {
+			if (iter->type == kMacroKeyframe and iter->tick + grace < position) {
+				this->seek(iter->tick);
+				return;
+			}
+		}
+	}
+}
+
+const std::vector<byte_t>* macro_player_t::resolve_seek() {
+	if (target == kNotReady) {
+		return nullptr;
+	}
+	const arch_t goal = std::min(target, total);
+	target = kNotReady;
+	const macro_chunk_t* found = nullptr;
+	for (auto&& chunk : chunks) {
+		if (chunk.type == kMacroKeyframe and chunk.tick <= goal) {
+			found = &chunk;
+		}
+	}
+	forward = goal;
+	if (found and (found->tick > position or goal < position)) {
+		if (!this->fetch(*found, keyframe)) {
+			synao_log("Keyframe at tick {} couldn't be read!\n", found->tick);
+			forward = 0;
+			return nullptr;
+		}
+		position = found->tick;
+		synao_log("Seeking to keyframe at tick {}, then {} more ticks.\n", found->tick, goal - found->tick);
+		return &keyframe;
+	}
+	if (goal < position) {
+		synao_log("No keyframe before tick {}!\n", goal);
+		forward = 0;
+	}
+	return nullptr;
+}
+
+bool macro_player_t::fast_forwarding() const {
+	return this->playing() and position < forward;
+}
+
+arch_t macro_player_t::tick() const {
+	return position;
+}
+
+bool macro_player_t::flush() {
+	if (buttons.empty()) {
+		return true;
+	}
+	const arch_t count = buttons.size() / 2;
+	// Pressed and held buttons are stored as separate planes, since each
+	// changes rarely on its own but the two interleaved almost never repeat
+	scratch.clear();
+	for (arch_t plane = 0; plane < 2; ++plane) {
+		arch_t it = 0;
+		while (it < count) {
+			const uint16_t value = buttons[it * 2 + plane];
+			arch_t run = 1;
+			while (it + run < count and buttons[(it + run) * 2 + plane] == value) {
+				++run;
+			}
+			write_varint(scratch, run);
+			scratch.push_back(static_cast<byte_t>(value & 0xFF));
+			scratch.push_back(static_cast<byte_t>(value >> 8));
+			it += run;
+		}
 	}
-	if ((index + 1) >= buttons.size()) {
+	const bool result = this->append(kMacroButtons, first, count, scratch);
+	buttons.clear();
+	first = position;
+	return result;
+}
+
+bool macro_player_t::fetch(arch_t tick) {
+	for (auto&& chunk : chunks) {
+		if (chunk.type == kMacroButtons and tick >= chunk.tick and tick < chunk.tick + chunk.count) {
+			if (!this->fetch(chunk, scratch)) {
+				break;
+			}
+			buttons.assign(chunk.count * 2, 0);
+			arch_t index = 0;
+			for (arch_t plane = 0; plane < 2; ++plane) {
+				arch_t it = 0;
+				while (it < chunk.count) {
+					arch_t run = 0;
+					if (!read_varint(scratch, index, run) or run == 0 or index + 2 > scratch.size() or it + run > chunk.count) {
+						synao_log("Macro chunk at tick {} is broken!\n", chunk.tick);
+						buttons.clear();
+						return false;
+					}
+					const uint16_t value = static_cast<uint16_t>(
+						static_cast<uint8_t>(scratch[index]) |
+						(static_cast<uint8_t>(scratch[index + 1]) << 8)
+					);
+					index += 2;
+					for (arch_t end = it + run; it < end; ++it) {
+						buttons[it * 2 + plane] = value;
+					}
+				}
+			}
+			first = chunk.tick;
+			return true;
+		}
+	}
+	synao_log("Macro has no inputs for tick {}!\n", tick);
+	return false;
+}
+
+bool macro_player_t::fetch(const macro_chunk_t& chunk, std::vector<byte_t>& payload) {
+	ifs.clear();
+	ifs.seekg(static_cast<std::streamoff>(chunk.offset + kMacroChunkSize), std::ios::beg);
+	payload.resize(chunk.size);
+	ifs.read(payload.data(), payload.size());
+	return ifs.good();
+}
+
+bool macro_player_t::append(uint8_t type, arch_t tick, arch_t count, const std::vector<byte_t>& payload) {
+	macro_chunk_t chunk {};
+	chunk.type = type;
+	chunk.tick = tick;
+	chunk.count = count;
+	chunk.offset = static_cast<arch_t>(ofs.tellp());
+	chunk.size = payload.size();
+	const uint64_t literal[3] = {
+		chunk.tick,
+		chunk.count,
+		chunk.size
+	};
+	ofs.write(reinterpret_cast<const byte_t*>(&chunk.type), sizeof(uint8_t));
+	ofs.write(reinterpret_cast<const byte_t*>(literal), sizeof(literal));
+	ofs.write(payload.data(), payload.size());
+	// Flushed per chunk so everything before a crash is still readable
+	ofs.flush();
+	if (!ofs.good()) {
+		synao_log("Error! Failed to write macro chunk!\n");
 		return false;
 	}
+	chunks.push_back(chunk);
 	return true;
 }
+
+void macro_player_t::scan(arch_t offset, arch_t length) {
+	ifs.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	while (offset + kMacroChunkSize <= length) {
+		macro_chunk_t chunk {};
+		uint64_t literal[3] = {};
+		ifs.read(reinterpret_cast<byte_t*>(&chunk.type), sizeof(uint8_t));
+		ifs.read(reinterpret_cast<byte_t*>(literal), sizeof(literal));
+		chunk.tick = static_cast<arch_t>(literal[0]);
+		chunk.count = static_cast<arch_t>(literal[1]);
+		chunk.offset = offset;
+		chunk.size = static_cast<arch_t>(literal[2]);
+		if (
+			!ifs.good() or
+			(chunk.type != kMacroButtons and chunk.type != kMacroKeyframe) or
+			chunk.size > length - offset - kMacroChunkSize
+		) {
+			break;
+		}
+		chunks.push_back(chunk);
+		offset += kMacroChunkSize + chunk.size;
+		ifs.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	}
+	ifs.clear();
+}
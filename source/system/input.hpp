@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <fstream>
 #include <bitset>
 #include <vector>
 #include <string>
@@ -64,6 +65,11 @@ public:
 	btn_t set_keyboard_binding(sint_t code, arch_t btn);
 	void set_joystick_scanner();
 	btn_t set_joystick_binding(sint_t code, arch_t btn);
+	bool keyframe_due() const;
+	void store_keyframe(const std::vector<byte_t>& data);
+	void seek_keyframe(sint_t step);
+	const std::vector<byte_t>* resolve_seek();
+	bool fast_forwarding() const;
 #ifdef LEVIATHAN_USES_META
 	bool get_meta_pressed(sint_t scancode) const;
 	bool get_meta_holding(sint_t scancode) const;
@@ -84,6 +90,17 @@ private:
 	SDL_Joystick* device { nullptr };
 };
 
+// Recordings are streamed to disk a chunk at a time, so a crash only loses
+// the chunk in progress and playback never holds more than one in memory
+struct macro_chunk_t {
+public:
+	uint8_t type { 0 };
+	arch_t tick { 0 };
+	arch_t count { 0 };
+	arch_t offset { 0 };
+	arch_t size { 0 };
+};
+
 struct macro_player_t : public not_copyable_t {
 public:
 	macro_player_t() = default;
@@ -93,16 +110,44 @@ public:
 	macro_player_t& operator=(macro_player_t&&) noexcept = default;
 	~macro_player_t() = default;
 public:
+	bool open(const std::string& name);
 	bool load(const std::string& name);
-	bool write(const std::string& output);
+	bool finish();
 	void read(std::bitset<btn_t::Total>& pressed, std::bitset<btn_t::Total>& holding);
 	void store(const std::bitset<btn_t::Total>& pressed, const std::bitset<btn_t::Total>& holding);
 	bool recording() const;
 	bool playing() const;
+	bool keyframe_due() const;
+	void store_keyframe(const std::vector<byte_t>& data);
+	void seek(arch_t tick);
+	void seek_keyframe(sint_t step);
+	const std::vector<byte_t>* resolve_seek();
+	bool fast_forwarding() const;
+	arch_t tick() const;
 public:
 	static constexpr arch_t kNotReady = (arch_t)-1;
+	// One minute of ticks between keyframes
+	static constexpr arch_t kKeyframeInterval = 3600;
+	static constexpr arch_t kChunkTicks = 1024;
+private:
+	bool flush();
+	bool fetch(arch_t tick);
+	bool fetch(const macro_chunk_t& chunk, std::vector<byte_t>& payload);
+	bool append(uint8_t type, arch_t tick, arch_t count, const std::vector<byte_t>& payload);
+	void scan(arch_t offset, arch_t length);
 private:
 	bool_t record { false };
-	arch_t index { kNotReady };
-	std::vector<std::bitset<btn_t::Total> > buttons {};
+	bool_t ready { false };
+	arch_t position { 0 };
+	arch_t total { 0 };
+	arch_t first { 0 };
+	arch_t target { kNotReady };
+	arch_t forward { 0 };
+	arch_t last_keyframe { 0 };
+	std::ofstream ofs {};
+	std::ifstream ifs {};
+	std::vector<uint16_t> buttons {};
+	std::vector<byte_t> scratch {};
+	std::vector<byte_t> keyframe {};
+	std::vector<macro_chunk_t> chunks {};
 };
@@ -8,6 +8,7 @@
 #include <nlohmann/json.hpp>
 
 #include "../system/receiver.hpp"
+#include "../system/snapshot.hpp"
 #include "../utility/logger.hpp"
 
 namespace {
@@ -184,6 +185,47 @@ void kernel_t::write(nlohmann::json& file) const {
 	}
 }
 
+void kernel_t::write(snapshot_writer_t& writer) const {
+	writer.value<uint64_t>(bitmask.to_ullong());
+	writer.value<uint64_t>(file_index);
+	writer.value(timer);
+	writer.string(field);
+	writer.value(identity);
+	writer.string(function);
+	writer.value(cursor);
+	writer.value<sint64_t>(item_ptr ? item_ptr - items.data() : -1);
+	writer.array(items);
+	writer.array(flags);
+}
+
+bool kernel_t::read(snapshot_reader_t& reader) {
+	uint64_t literal_bitmask = 0;
+	uint64_t literal_index = 0;
+	sint64_t literal_item_ptr = -1;
+	reader.value(literal_bitmask);
+	reader.value(literal_index);
+	reader.value(timer);
+	reader.string(field);
+	reader.value(identity);
+	reader.string(function);
+	reader.value(cursor);
+	reader.value(literal_item_ptr);
+	reader.array(items);
+	reader.array(flags);
+	if (!reader.valid()) {
+		synao_log("Kernel snapshot is broken!\n");
+		return false;
+	}
+	bitmask = std::bitset<states_t::TotalStates>(literal_bitmask);
+	file_index = static_cast<arch_t>(literal_index);
+	if (literal_item_ptr >= 0 and static_cast<arch_t>(literal_item_ptr) < items.size()) {
+		item_ptr = &items[static_cast<arch_t>(literal_item_ptr)];
+	} else {
+		item_ptr = nullptr;
+	}
+	return true;
+}
+
 void kernel_t::boot() {
 	bitmask[states_t::Boot] = true;
 }
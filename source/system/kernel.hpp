@@ -17,6 +17,8 @@ struct audio_t;
 struct music_t;
 struct renderer_t;
 struct receiver_t;
+struct snapshot_writer_t;
+struct snapshot_reader_t;
 
 struct kernel_t : public not_copyable_t, public not_moveable_t {
 public:
@@ -44,6 +46,8 @@ public:
 	void update(real64_t delta);
 	void read(const nlohmann::json& file);
 	void write(nlohmann::json& file) const;
+	void write(snapshot_writer_t& writer) const;
+	bool read(snapshot_reader_t& reader);
 	void boot();
 	void quit();
 	void lock();
@@ -97,6 +97,11 @@ bool receiver_t::init(input_t& input, audio_t& audio, music_t& music, kernel_t&
 }
 
 void receiver_t::reset() {
+	this->abort();
+	this->discard_all_events();
+}
+
+void receiver_t::abort() {
 	if (bitmask[flags_t::Running]) {
 		state->Abort();
 		state->Unprepare();
@@ -106,7 +111,6 @@ void receiver_t::reset() {
 	bitmask[flags_t::Stalled] = false;
 	timer = 0.0f;
 	calls = 0;
-	this->discard_all_events();
 }
 
 void receiver_t::handle(const input_t& input, kernel_t& kernel, const stack_gui_t& stack_gui, dialogue_gui_t& dialogue_gui, const inventory_gui_t& inventory_gui, headsup_gui_t& headsup_gui) {
@@ -913,6 +917,46 @@ void receiver_t::generate_functions(input_t& input, audio_t& audio, music_t& mus
 	// Is Actor Still
 	r = engine->RegisterGlobalFunction("bool still(sint32_t id)", WRAP_MFN(kontext_t, still), asCALL_THISCALL_ASGLOBAL, &kontext);
 	assert(r >= 0);
+	// Batched calls cross into the engine once for a whole group of actors
+	// Spawn Actors
+	r = engine->RegisterGlobalFunction("bool spawn(const std::string &in name, const std::array<real32_t> &in x, const std::array<real32_t> &in y, const std::array<sint32_t> &in id)", WRAP_MFN(kontext_t, create_minimally_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Kill Actors
+	r = engine->RegisterGlobalFunction("void kill(const std::array<sint32_t> &in id)", WRAP_MFN(kontext_t, kill_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Destroy Actors
+	r = engine->RegisterGlobalFunction("void destroy(const std::array<sint32_t> &in id)", WRAP_MFN(kontext_t, destroy_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Destroy Actors Of Type
+	r = engine->RegisterGlobalFunction("void destroy_all(const std::string &in type)", WRAP_MFN(kontext_t, destroy_all), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Bump Actors
+	r = engine->RegisterGlobalFunction("void move(const std::array<sint32_t> &in id, real32_t velocity_x, real32_t velocity_y)", WRAP_MFN(kontext_t, bump_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Bump Actors Of Type
+	r = engine->RegisterGlobalFunction("void move_all(const std::string &in type, real32_t velocity_x, real32_t velocity_y)", WRAP_MFN(kontext_t, bump_all), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Animate Actors
+	r = engine->RegisterGlobalFunction("void animate(const std::array<sint32_t> &in id, arch_t state, arch_t variation)", WRAP_MFN(kontext_t, animate_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Animate Actors Of Type
+	r = engine->RegisterGlobalFunction("void animate_all(const std::string &in type, arch_t state, arch_t variation)", WRAP_MFN(kontext_t, animate_all), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Set Actors State
+	r = engine->RegisterGlobalFunction("void set_state(const std::array<sint32_t> &in id, arch_t state)", WRAP_MFN(kontext_t, set_state_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Set Actors Of Type State
+	r = engine->RegisterGlobalFunction("void set_state_all(const std::string &in type, arch_t state)", WRAP_MFN(kontext_t, set_state_all), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Are Actors Still
+	r = engine->RegisterGlobalFunction("bool still(const std::array<sint32_t> &in id)", WRAP_MFN(kontext_t, still_n), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Get Identities Of Type
+	r = engine->RegisterGlobalFunction("std::array<sint32_t>@ find_all(const std::string &in type)", WRAP_MFN(kontext_t, identities), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
+	// Get Actor Positions
+	r = engine->RegisterGlobalFunction("std::array<real32_t>@ position(const std::array<sint32_t> &in id)", WRAP_MFN(kontext_t, positions), asCALL_THISCALL_ASGLOBAL, &kontext);
+	assert(r >= 0);
 
 	// Set Namespace
 	r = engine->SetDefaultNamespace("nao");
@@ -6,9 +6,23 @@
 #include "../utility/logger.hpp"
 #include "../video/frame-buffer.hpp"
 
+#include <cmath>
 #include <limits>
+#include <algorithm>
+#include <glm/common.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+namespace {
+	constexpr display_key_t kProgramBits = 3;
+	constexpr display_key_t kBlendBits = 3;
+	constexpr display_key_t kLayerBits = 7;
+	constexpr sint_t kLayerSteps = 10;
+	constexpr sint_t kLayerBias = 1 << (kLayerBits - 1);
+	constexpr arch_t kTableSize = 1 << (kLayerBits + kBlendBits + kProgramBits);
+
+	static_assert(program_t::Total <= (1 << kProgramBits));
+}
+
 bool renderer_t::init(vfs_t& fs) {
 	arch_t amount = static_cast<arch_t>(std::numeric_limits<uint16_t>::max());
 	if (!quad_allocator.create(primitive_t::Triangles, amount)) {
@@ -24,6 +38,7 @@ bool renderer_t::init(vfs_t& fs) {
 		return false;
 	}
 	pipelines.resize(program_t::Total);
+	display_table.assign(kTableSize, 0);
 	if (viewports.valid()) {
 		synao_log("Constant buffers already exist!\n");
 		return false;
@@ -41,6 +56,16 @@ bool renderer_t::init(vfs_t& fs) {
 	viewports.update(matrices);
 	internal_state.set_buffer(&viewports, 0);
 
+	// Each parallax layer takes a bounding and a scrolling vector
+	const arch_t parallax_length = sizeof(glm::vec4) * 2 * renderer_t::MaximumParallaxes;
+	parallaxes.setup(buffer_usage_t::Dynamic);
+	if (const_buffer_t::has_immutable_option()) {
+		parallaxes.create_immutable(parallax_length);
+	} else {
+		parallaxes.create(parallax_length);
+	}
+	internal_state.set_buffer(&parallaxes, 1);
+
 	const shader_t* blank = vfs_t::shader(
 		"blank",
 		program::blank_vert(),
@@ -56,6 +81,11 @@ bool renderer_t::init(vfs_t& fs) {
 		program::fonts_vert(),
 		shader_stage_t::Vertex
 	);
+	const shader_t* tiles = vfs_t::shader(
+		"tiles",
+		program::tiles_vert(),
+		shader_stage_t::Vertex
+	);
 	const shader_t* colors = vfs_t::shader(
 		"colors",
 		program::colors_frag(),
@@ -71,50 +101,129 @@ bool renderer_t::init(vfs_t& fs) {
 		program::channels_frag(),
 		shader_stage_t::Fragment
 	);
+	const shader_t* parallax = vfs_t::shader(
+		"parallax",
+		program::parallax_frag(),
+		shader_stage_t::Fragment
+	);
+	const shader_t* indexed = vfs_t::shader(
+		"indexed",
+		program::indexed_frag(),
+		shader_stage_t::Fragment
+	);
 	bool result = pipelines[program_t::Colors].create(blank, colors);
 	if (!result) {
 		synao_log("\"Colors\" program creation failed!\n");
 		return false;
 	}
+	result = pipelines[program_t::Parallax].create(tiles, parallax);
+	if (!result) {
+		synao_log("\"Parallax\" program creation failed!\n");
+		return false;
+	}
 	result = pipelines[program_t::Sprites].create(major, sprites);
 	if (!result) {
 		synao_log("\"Sprites\" program creation failed!\n");
 		return false;
 	}
+	instancing = false;
+	if (quad_buffer_t::has_instancing()) {
+		const shader_t* sprite = vfs_t::shader(
+			"sprite",
+			program::sprite_vert(),
+			shader_stage_t::Vertex
+		);
+		instancing = (
+			pipelines[program_t::Instances].create(sprite, sprites) and
+			pipelines[program_t::Instances].get_specify().instanced
+		);
+		if (!instancing) {
+			synao_log("\"Instances\" program creation failed! Sprites will use quads instead.\n");
+		}
+	}
 	result = pipelines[program_t::Strings].create(fonts, channels);
 	if (!result) {
 		synao_log("\"Strings\" program creation failed!\n");
 	}
+	tilemap_program = pipelines[program_t::Tilemap].create(tiles, indexed);
+	if (!tilemap_program) {
+		synao_log("\"Tilemap\" program creation failed! Tiles will use quads instead.\n");
+	}
+	// Programs that read the same vertex format share one arena
+	arenas.clear();
+	arenas.reserve(program_t::Total);
+	for (arch_t it = 0; it < program_t::Total; ++it) {
+		const vertex_spec_t& specify = pipelines[it].get_specify();
+		arch_t index = 0;
+		while (index < arenas.size() and arenas[index].get_specify() != specify) {
+			++index;
+		}
+		if (index == arenas.size()) {
+			arenas.emplace_back().setup(&quad_allocator, specify);
+		}
+		arena_indices[it] = index;
+	}
 	if (!pipeline_t::has_separable()) {
 		pipelines[program_t::Colors].set_block("transforms", 0);
+		pipelines[program_t::Parallax].set_block("transforms", 0);
+		pipelines[program_t::Parallax].set_block("parallaxes", 1);
+		pipelines[program_t::Parallax].set_sampler("diffuse", 0);
 		pipelines[program_t::Sprites].set_block("transforms", 0);
 		pipelines[program_t::Sprites].set_sampler("diffuse", 0);
 		pipelines[program_t::Strings].set_block("transforms", 0);
 		pipelines[program_t::Strings].set_sampler("channels", 1);
+		pipelines[program_t::Tilemap].set_block("transforms", 0);
+		pipelines[program_t::Tilemap].set_sampler("diffuse", 0);
+		pipelines[program_t::Tilemap].set_sampler("indices", static_cast<arch_t>(sampler_indices_t::get_binding_unit()));
 	}
 	synao_log("Rendering service is ready.\n");
 	return true;
 }
 
 void renderer_t::clear() {
+	display_order.clear();
 	display_lists.clear();
+	std::fill(display_table.begin(), display_table.end(), 0);
+	++epoch;
 }
 
 void renderer_t::flush(const video_t& video, const glm::mat4& viewport) {
 	// Update Viewports
-	static glm::mat4 current { 1.0f };
-	if (current != viewport) {
-		current = viewport;
-		viewports.update(&current, sizeof(glm::mat4), sizeof(glm::mat4));
+	if (viewport_matrix != viewport) {
+		viewport_matrix = viewport;
+		viewports.update(&viewport_matrix, sizeof(glm::mat4), sizeof(glm::mat4));
 	}
 	this->flush(video.get_integral_dimensions());
 }
 
 void renderer_t::flush(const glm::ivec2& dimensions) {
-	// Draw Lists
 	frame_buffer::clear(dimensions);
-	for (auto&& list : display_lists) {
-		list.flush(internal_state, &sampler_allocator);
+	// Upload Arenas
+	for (auto&& arena : arenas) {
+		arena.flush();
+	}
+	// Draw Lists
+	calls = 0;
+	const display_list_t* head = nullptr;
+	for (auto&& [key, index] : display_order) {
+		auto& list = display_lists[index];
+		if (list.empty()) {
+			list.flush();
+			continue;
+		}
+		if (head and !head->batches(list)) {
+			head->draw(internal_state, &sampler_allocator);
+			++calls;
+			head = nullptr;
+		}
+		if (!head) {
+			head = &list;
+		}
+		list.flush();
+	}
+	if (head) {
+		head->draw(internal_state, &sampler_allocator);
+		++calls;
 	}
 }
 
@@ -133,29 +242,77 @@ arch_t renderer_t::get_total_lists() const {
 }
 
 arch_t renderer_t::get_total_calls() const {
-	arch_t result = 0;
-	for (auto&& list : display_lists) {
-		if (list.rendered()) {
-			result++;
-		}
+	return calls;
+}
+
+bool renderer_t::has_instancing() const {
+	return instancing;
+}
+
+bool renderer_t::has_tilemap_program() const {
+	return tilemap_program;
+}
+
+void renderer_t::update_parallaxes(const glm::vec4* parameters, arch_t count) {
+	if (parallaxes.valid() and count > 0) {
+		count = glm::min(count, renderer_t::MaximumParallaxes * 2);
+		parallaxes.update(parameters, sizeof(glm::vec4) * count);
 	}
-	return result;
 }
 
 display_list_t& renderer_t::display_list(layer_t layer, blend_mode_t blend_mode, program_t program) {
-	for (auto&& list : display_lists) {
-		if (list.matches(layer, blend_mode, &pipelines[program])) {
-			return list;
-		}
+	return this->display_list(renderer_t::key(layer, blend_mode, program));
+}
+
+display_list_t& renderer_t::display_list(display_key_t key) {
+	arch_t& slot = display_table[key];
+	if (slot == 0) {
+		const sint_t step = static_cast<sint_t>(key >> (kBlendBits + kProgramBits));
+		const layer_t layer = static_cast<layer_t>(step - kLayerBias) / static_cast<layer_t>(kLayerSteps);
+		const auto blend_mode = static_cast<blend_mode_t>((key >> kProgramBits) & ((1 << kBlendBits) - 1));
+		const auto program = static_cast<program_t>(key & ((1 << kProgramBits) - 1));
+		display_lists.emplace_back(
+			layer, blend_mode,
+			&pipelines[program],
+			&arenas[arena_indices[program]]
+		);
+		slot = display_lists.size();
+		// Keys already compare in draw order, so a new list is inserted in place
+		auto iter = std::upper_bound(
+			display_order.begin(),
+			display_order.end(),
+			key,
+			[](display_key_t value, const std::pair<display_key_t, arch_t>& entry) {
+				return value < entry.first;
+			}
+		);
+		display_order.emplace(iter, key, slot - 1);
 	}
-	display_lists.emplace_back(
-		layer, blend_mode,
-		&pipelines[program]
-	);
-	std::sort(display_lists.begin(), display_lists.end());
-	return this->display_list(
-		layer,
-		blend_mode,
-		program
-	).setup(&quad_allocator);
+	return display_lists[slot - 1];
+}
+
+display_list_t& renderer_t::display_list(display_handle_t& handle, layer_t layer, blend_mode_t blend_mode, program_t program) {
+	if (
+		handle.epoch != epoch or
+		handle.layer != layer or
+		handle.blend_mode != blend_mode or
+		handle.program != program
+	) {
+		handle.layer = layer;
+		handle.blend_mode = blend_mode;
+		handle.program = program;
+		handle.epoch = epoch;
+		handle.list = &this->display_list(layer, blend_mode, program);
+	}
+	return *handle.list;
+}
+
+display_key_t renderer_t::key(layer_t layer, blend_mode_t blend_mode, program_t program) {
+	// Layers within a tenth of each other share a list, like layer_value::equal
+	sint_t step = static_cast<sint_t>(std::lround(layer * static_cast<layer_t>(kLayerSteps))) + kLayerBias;
+	step = glm::clamp(step, 0, (1 << kLayerBits) - 1);
+	return
+		(static_cast<display_key_t>(step) << (kBlendBits + kProgramBits)) |
+		(static_cast<display_key_t>(blend_mode) << kProgramBits) |
+		static_cast<display_key_t>(program);
 }
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <array>
+#include <deque>
+#include <utility>
+#include <glm/mat4x4.hpp>
+
 #include "../resource/program.hpp"
 #include "../utility/enums.hpp"
 #include "../video/const-buffer.hpp"
+#include "../video/display-handle.hpp"
 #include "../video/display-list.hpp"
 #include "../video/pipeline.hpp"
 #include "../video/sampler.hpp"
@@ -10,6 +16,11 @@
 struct vfs_t;
 struct video_t;
 
+// Packs a list's layer, blend mode and program so that keys compare in draw
+// order. Lists never move once created, so callers that draw every frame keep
+// a display_handle_t instead of looking the key up again.
+using display_key_t = uint_t;
+
 struct renderer_t : public not_copyable_t, public not_moveable_t {
 public:
 	renderer_t() = default;
@@ -22,12 +33,31 @@ public:
 	void ortho(const glm::ivec2& dimensions);
 	arch_t get_total_lists() const;
 	arch_t get_total_calls() const;
+	bool has_instancing() const;
+	bool has_tilemap_program() const;
+	void update_parallaxes(const glm::vec4* parameters, arch_t count);
 	display_list_t& display_list(layer_t layer, blend_mode_t blend_mode, program_t program);
+	display_list_t& display_list(display_key_t key);
+	display_list_t& display_list(display_handle_t& handle, layer_t layer, blend_mode_t blend_mode, program_t program);
+public:
+	static display_key_t key(layer_t layer, blend_mode_t blend_mode, program_t program);
+	static constexpr arch_t MaximumParallaxes = 16;
 private:
 	quad_allocator_t quad_allocator {};
 	sampler_allocator_t sampler_allocator {};
-	std::vector<display_list_t> display_lists {};
+	// Declared ahead of the lists, since lists give their spans back on destruction
+	std::vector<vertex_arena_t> arenas {};
+	std::array<arch_t, program_t::Total> arena_indices {};
+	std::deque<display_list_t> display_lists {};
+	std::vector<std::pair<display_key_t, arch_t> > display_order {};
+	std::vector<arch_t> display_table {};
 	std::vector<pipeline_t> pipelines {};
+	arch_t calls { 0 };
+	arch_t epoch { 1 };
+	bool_t instancing { false };
+	bool_t tilemap_program { false };
 	const_buffer_t viewports {};
+	glm::mat4 viewport_matrix { 1.0f };
+	const_buffer_t parallaxes {};
 	gfx_t internal_state {};
 };
@@ -4,6 +4,7 @@
 #include <glm/gtc/constants.hpp>
 #include <nlohmann/json.hpp>
 #include <tmxlite/Map.hpp>
+#include <SDL2/SDL_scancode.h>
 
 #include "../component/location.hpp"
 #include "../component/health.hpp"
@@ -16,6 +17,7 @@
 #include "../system/renderer.hpp"
 #include "../utility/constants.hpp"
 #include "../utility/logger.hpp"
+#include "../utility/rng.hpp"
 
 namespace {
 	constexpr byte_t kStatProgess[] 	= "progress-";
@@ -26,6 +28,9 @@ namespace {
 	constexpr byte_t kPositionEntry[] 	= "Position";
 	constexpr byte_t kDirectionEntry[] 	= "Direction";
 	constexpr byte_t kEquipmentEntry[] 	= "Equipment";
+	constexpr uint_t kSnapshotVersion = 4;
+	// A quarter second apart, so the ring holds about sixteen seconds
+	constexpr arch_t kSnapshotInterval = 15;
 }
 
 bool runtime_t::init(input_t& input, video_t& video, audio_t& audio, music_t& music, renderer_t& renderer) {
@@ -61,8 +66,16 @@ bool runtime_t::init(input_t& input, video_t& video, audio_t& audio, music_t& mu
 }
 
 bool runtime_t::handle(config_t& config, input_t& input, video_t& video, audio_t& audio, music_t& music, renderer_t& renderer) {
-	while (this->viable()) {
+	// Seeking in a recording simulates the ticks after a keyframe without waiting on the clock
+	while (this->viable() or input.fast_forwarding()) {
 		accum = glm::max(accum - constants::MinInterval(), 0.0);
+		const std::vector<byte_t>* keyframe = input.resolve_seek();
+		if (keyframe and !this->read_world(config, audio, renderer, *keyframe)) {
+			synao_log("Couldn't restore recording keyframe!\n");
+		}
+		if (input.keyframe_due() and this->write_world(snapshot_buffer)) {
+			input.store_keyframe(snapshot_buffer);
+		}
 		input.advance();
 		if (headsup_gui.is_fade_done()) {
 			if (kernel.has(kernel_t::Language)) {
@@ -77,7 +90,7 @@ bool runtime_t::handle(config_t& config, input_t& input, video_t& video, audio_t
 				this->setup_load(video, renderer);
 			}
 			if (kernel.has(kernel_t::Field)) {
-				if (!this->setup_field(audio, renderer)) {
+				if (!this->setup_field(config, audio, renderer)) {
 					return false;
 				}
 			}
@@ -98,9 +111,21 @@ bool runtime_t::handle(config_t& config, input_t& input, video_t& video, audio_t
 			naomi.handle(input, audio, kernel, receiver, headsup_gui, kontext, tilemap);
 			kontext.handle(input, audio, kernel, receiver, headsup_gui, camera, naomi, tilemap);
 			tilemap.handle(camera);
+			if (practice and ++snapshot_ticks >= kSnapshotInterval) {
+				snapshot_ticks = 0;
+				this->capture_snapshot();
+			}
 		}
 #ifdef LEVIATHAN_USES_META
-		meta_state.handle(input);
+		if (practice and input.get_meta_pressed(SDL_SCANCODE_F5)) {
+			this->restore_snapshot(config, audio, renderer);
+		}
+		if (input.get_meta_pressed(SDL_SCANCODE_F6)) {
+			input.seek_keyframe(-1);
+		} else if (input.get_meta_pressed(SDL_SCANCODE_F7)) {
+			input.seek_keyframe(1);
+		}
+		meta_state.handle(input, kontext.get_census());
 #endif
 		input.flush();
 		audio.flush();
@@ -160,8 +185,11 @@ bool runtime_t::setup_language(config_t& config, renderer_t& renderer) {
 	return true;
 }
 
-bool runtime_t::setup_field(audio_t& audio, renderer_t& renderer) {
+bool runtime_t::setup_field(config_t& config, audio_t& audio, renderer_t& renderer) {
 	renderer.clear();
+	practice = config.get_practice();
+	snapshot_ticks = 0;
+	snapshots.reset();
 	kernel.lock();
 	receiver.reset();
 	stack_gui.reset();
@@ -184,7 +212,7 @@ bool runtime_t::setup_field(audio_t& audio, renderer_t& renderer) {
 	camera.set_view_limits(
 		ftcv::rect_to_rect(tmxmap.getBounds())
 	);
-	tilemap.push_properties(tmxmap);
+	tilemap.push_properties(tmxmap, renderer);
 	for (auto&& layer : tmxmap.getLayers()) {
 		switch (layer->getType()) {
 		case tmx::Layer::Type::Tile:
@@ -201,7 +229,11 @@ bool runtime_t::setup_field(audio_t& audio, renderer_t& renderer) {
 		}
 	}
 	naomi.setup(audio, kernel, camera, kontext);
+	tilemap.handle(camera);
 	kernel.finish_field();
+#ifdef LEVIATHAN_BUILD_DEBUG
+	kontext.report();
+#endif
 	synao_log("Field loading successful.\n");
 	return true;
 }
@@ -369,3 +401,75 @@ void runtime_t::setup_save() {
 	}
 	kernel.finish_file_operation();
 }
+
+// World state is only written between ticks while no script is suspended,
+// because a script's stack can't be captured alongside the world.
+bool runtime_t::write_world(std::vector<byte_t>& buffer) {
+	if (receiver.running() or kernel.has(kernel_t::Field)) {
+		return false;
+	}
+	snapshot_writer_t writer { buffer };
+	writer.value(kSnapshotVersion);
+	writer.string(kernel.get_field());
+	writer.string(rng::state());
+	kernel.write(writer);
+	camera.write(writer);
+	naomi.write(writer);
+	kontext.write(writer);
+	writer.finish();
+	return true;
+}
+
+bool runtime_t::read_world(config_t& config, audio_t& audio, renderer_t& renderer, const std::vector<byte_t>& buffer) {
+	snapshot_reader_t reader { buffer };
+	uint_t version = 0;
+	std::string field {};
+	std::string state {};
+	reader.value(version);
+	reader.string(field);
+	reader.string(state);
+	if (!reader.valid() or version != kSnapshotVersion) {
+		synao_log("Snapshot has an unknown layout!\n");
+		return false;
+	}
+	if (field != kernel.get_field() or kernel.has(kernel_t::Field)) {
+		kernel.buffer_field(field, 0);
+		if (!this->setup_field(config, audio, renderer)) {
+			return false;
+		}
+	}
+	// Anything the field's entry script started didn't exist when the snapshot was taken
+	receiver.abort();
+	if (
+		!rng::state(state) or
+		!kernel.read(reader) or
+		!camera.read(reader) or
+		!naomi.read(reader) or
+		!kontext.read(reader)
+	) {
+		synao_log("Snapshot restoration failed!\n");
+		return false;
+	}
+	return true;
+}
+
+void runtime_t::capture_snapshot() {
+	if (this->write_world(snapshot_buffer)) {
+		snapshots.push(snapshot_buffer);
+	}
+}
+
+bool runtime_t::restore_snapshot(config_t& config, audio_t& audio, renderer_t& renderer) {
+	if (receiver.running() or !snapshots.get(0, snapshot_buffer)) {
+		return false;
+	}
+	if (!this->read_world(config, audio, renderer, snapshot_buffer)) {
+		snapshots.reset();
+		return false;
+	}
+	// Dropping what was just restored lets repeated rewinds walk further back
+	snapshots.drop(1);
+	snapshot_ticks = 0;
+	synao_log("Rewound to snapshot, {} left.\n", snapshots.size());
+	return true;
+}
@@ -2,6 +2,7 @@
 
 #include "./kernel.hpp"
 #include "./receiver.hpp"
+#include "./snapshot.hpp"
 
 #include "../actor/naomi.hpp"
 #include "../component/kontext.hpp"
@@ -32,12 +33,20 @@ public:
 	bool viable() const;
 private:
 	bool setup_language(config_t& config, renderer_t& renderer);
-	bool setup_field(audio_t& audio, renderer_t& renderer);
+	bool setup_field(config_t& config, audio_t& audio, renderer_t& renderer);
 	void setup_boot(const video_t& video, renderer_t& renderer);
 	void setup_load(const video_t& video, renderer_t& renderer);
 	void setup_save();
+	bool write_world(std::vector<byte_t>& buffer);
+	bool read_world(config_t& config, audio_t& audio, renderer_t& renderer, const std::vector<byte_t>& buffer);
+	void capture_snapshot();
+	bool restore_snapshot(config_t& config, audio_t& audio, renderer_t& renderer);
 private:
 	real64_t accum { 0.0 };
+	bool_t practice { false };
+	arch_t snapshot_ticks { 0 };
+	snapshot_ring_t snapshots {};
+	std::vector<byte_t> snapshot_buffer {};
 	kernel_t kernel {};
 	receiver_t receiver {};
 	stack_gui_t stack_gui {};
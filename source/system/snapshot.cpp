@@ -0,0 +1,332 @@
+#include "./snapshot.hpp"
+
+#include "../utility/logger.hpp"
+
+#ifdef LEVIATHAN_DEFINES_VERSION
+	#include <leviathan-racket.hpp>
+#else
+	#include "../version.inc"
+#endif
+
+#include <cstring>
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace {
+	constexpr arch_t kRingCapacity = 64;
+	constexpr arch_t kKeyframeInterval = 8;
+	// Shorter matches are cheaper to copy than to describe
+	constexpr arch_t kMinimumRun = 4;
+
+	void write_varint(std::vector<byte_t>& output, arch_t value) {
+		while (value >= 0x80) {
+			output.push_back(static_cast<byte_t>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		output.push_back(static_cast<byte_t>(value));
+	}
+
+	bool read_varint(const std::vector<byte_t>& input, arch_t& index, arch_t& value) {
+		value = 0;
+		arch_t shift = 0;
+		while (index < input.size() and shift < sizeof(arch_t) * 8) {
+			const arch_t data = static_cast<uint8_t>(input[index++]);
+			value |= (data & 0x7F) << shift;
+			if (!(data & 0x80)) {
+				return true;
+			}
+			shift += 7;
+		}
+		return false;
+	}
+}
+
+uint64_t snapshot::build_id() {
+	static const uint64_t id = [] {
+		const std::string description = fmt::format(
+			"{}.{}.{}.{}-{}-{}-{}-{} {}",
+			LEVIATHAN_VERSION_INFORMATION_MAJOR,
+			LEVIATHAN_VERSION_INFORMATION_MINOR,
+			LEVIATHAN_VERSION_INFORMATION_PATCH,
+			LEVIATHAN_VERSION_INFORMATION_TWEAK,
+			LEVIATHAN_VERSION_INFORMATION_STAMP,
+#if defined(__VERSION__)
+			__VERSION__,
+#elif defined(_MSC_FULL_VER)
+			_MSC_FULL_VER,
+#else
+			0,
+#endif
+			sizeof(void_t),
+			__DATE__, __TIME__
+		);
+		// FNV-1a
+		uint64_t result = 0xCBF29CE484222325;
+		for (auto&& character : description) {
+			result ^= static_cast<uint8_t>(character);
+			result *= 0x100000001B3;
+		}
+		return result;
+	}();
+	return id;
+}
+
+snapshot_writer_t::snapshot_writer_t(std::vector<byte_t>& buffer) : buffer(buffer) {
+	// Reserved for the offset of the name table
+	buffer.clear();
+	this->value<uint64_t>(0);
+}
+
+void snapshot_writer_t::string(const std::string& data) {
+	this->value<uint64_t>(data.size());
+	this->bytes(data.data(), data.size());
+}
+
+void snapshot_writer_t::name(const entt::hashed_string& data) {
+	const entt::id_type id = data.value();
+	if (id != 0 and names.find(id) == names.end()) {
+		names.emplace(id, data.data());
+	}
+	this->value(id);
+}
+
+void snapshot_writer_t::finish() {
+	const uint64_t offset = buffer.size();
+	this->value<uint64_t>(names.size());
+	for (auto&& [id, data] : names) {
+		this->value(id);
+		this->string(data ? data : "");
+	}
+	std::memcpy(buffer.data(), &offset, sizeof(uint64_t));
+	names.clear();
+}
+
+void snapshot_writer_t::bytes(const void* data, arch_t length) {
+	if (length > 0) {
+		const arch_t index = buffer.size();
+		buffer.resize(index + length);
+		std::memcpy(buffer.data() + index, data, length);
+	}
+}
+
+snapshot_reader_t::snapshot_reader_t(const std::vector<byte_t>& buffer) : buffer(buffer) {
+	limit = buffer.size();
+	uint64_t offset = 0;
+	if (!this->value(offset) or offset < sizeof(uint64_t) or offset > buffer.size()) {
+		synao_log("Snapshot header is broken!\n");
+		failed = true;
+		return;
+	}
+	index = static_cast<arch_t>(offset);
+	uint64_t count = 0;
+	this->value(count);
+	for (uint64_t it = 0; it < count and !failed; ++it) {
+		entt::id_type id = 0;
+		std::string data;
+		if (this->value(id) and this->string(data)) {
+			names.emplace(id, std::move(data));
+		}
+	}
+	limit = static_cast<arch_t>(offset);
+	index = sizeof(uint64_t);
+}
+
+bool snapshot_reader_t::string(std::string& data) {
+	uint64_t length = 0;
+	if (!this->value(length) or length > limit - index) {
+		failed = true;
+		return false;
+	}
+	data.assign(buffer.data() + index, static_cast<arch_t>(length));
+	index += static_cast<arch_t>(length);
+	return true;
+}
+
+bool snapshot_reader_t::name(const std::string*& data) {
+	entt::id_type id = 0;
+	if (!this->value(id)) {
+		return false;
+	}
+	if (id == 0) {
+		data = nullptr;
+		return true;
+	}
+	auto iter = names.find(id);
+	if (iter == names.end()) {
+		synao_log("Snapshot is missing name {}!\n", id);
+		failed = true;
+		return false;
+	}
+	data = &iter->second;
+	return true;
+}
+
+bool snapshot_reader_t::valid() const {
+	return !failed;
+}
+
+bool snapshot_reader_t::bytes(void* data, arch_t length) {
+	if (failed or length > limit - index) {
+		failed = true;
+		return false;
+	}
+	if (length > 0) {
+		std::memcpy(data, buffer.data() + index, length);
+		index += length;
+	}
+	return true;
+}
+
+void snapshot_ring_t::reset() {
+	entries.clear();
+	head = 0;
+	length = 0;
+	since = 0;
+	latest.clear();
+}
+
+void snapshot_ring_t::push(const std::vector<byte_t>& buffer) {
+	if (entries.size() != kRingCapacity) {
+		entries.resize(kRingCapacity);
+	}
+	if (length == kRingCapacity) {
+		// The oldest entry is always a keyframe, so the next one can be
+		// rebuilt from it before it goes away
+		entry_t& next = entries[(head + 1) % kRingCapacity];
+		if (!next.keyframe) {
+			std::vector<byte_t> full;
+			snapshot_ring_t::decode(entries[head].data, next.data, full);
+			next.data = std::move(full);
+			next.keyframe = true;
+		}
+		entries[head].data.clear();
+		head = (head + 1) % kRingCapacity;
+		--length;
+	}
+	entry_t& entry = entries[(head + length) % kRingCapacity];
+	if (length == 0 or since + 1 >= kKeyframeInterval) {
+		entry.keyframe = true;
+		entry.data = buffer;
+		since = 0;
+	} else {
+		entry.keyframe = false;
+		snapshot_ring_t::encode(latest, buffer, entry.data);
+		++since;
+	}
+	++length;
+	latest = buffer;
+}
+
+bool snapshot_ring_t::get(arch_t age, std::vector<byte_t>& buffer) const {
+	if (age >= length) {
+		return false;
+	}
+	if (age == 0) {
+		buffer = latest;
+		return true;
+	}
+	return this->rebuild(length - 1 - age, buffer);
+}
+
+void snapshot_ring_t::drop(arch_t count) {
+	if (count >= length) {
+		this->reset();
+		return;
+	}
+	for (arch_t it = 0; it < count; ++it) {
+		entries[(head + length - 1 - it) % kRingCapacity].data.clear();
+	}
+	length -= count;
+	this->rebuild(length - 1, latest);
+	since = 0;
+	while (!entries[(head + length - 1 - since) % kRingCapacity].keyframe) {
+		++since;
+	}
+}
+
+arch_t snapshot_ring_t::size() const {
+	return length;
+}
+
+arch_t snapshot_ring_t::bytes() const {
+	arch_t result = 0;
+	for (auto&& entry : entries) {
+		result += entry.data.size();
+	}
+	return result;
+}
+
+void snapshot_ring_t::encode(const std::vector<byte_t>& previous, const std::vector<byte_t>& current, std::vector<byte_t>& output) {
+	output.clear();
+	write_varint(output, current.size());
+	const arch_t total = current.size();
+	const arch_t shared = std::min(previous.size(), total);
+	arch_t index = 0;
+	while (index < total) {
+		const arch_t first = index;
+		while (index < shared and current[index] == previous[index]) {
+			++index;
+		}
+		const arch_t skip = index - first;
+		const arch_t literal = index;
+		while (index < total) {
+			arch_t run = 0;
+			while (index + run < shared and run < kMinimumRun and current[index + run] == previous[index + run]) {
+				++run;
+			}
+			if (run >= kMinimumRun) {
+				break;
+			}
+			index += run > 0 ? run : 1;
+		}
+		write_varint(output, skip);
+		write_varint(output, index - literal);
+		output.insert(output.end(), current.begin() + literal, current.begin() + index);
+	}
+}
+
+bool snapshot_ring_t::decode(const std::vector<byte_t>& previous, const std::vector<byte_t>& delta, std::vector<byte_t>& output) {
+	arch_t index = 0;
+	arch_t total = 0;
+	if (!read_varint(delta, index, total)) {
+		return false;
+	}
+	output.resize(total);
+	arch_t position = 0;
+	while (index < delta.size()) {
+		arch_t skip = 0;
+		arch_t literal = 0;
+		if (!read_varint(delta, index, skip) or !read_varint(delta, index, literal)) {
+			return false;
+		}
+		if (position + skip > previous.size() or position + skip + literal > total or index + literal > delta.size()) {
+			return false;
+		}
+		std::memcpy(output.data() + position, previous.data() + position, skip);
+		position += skip;
+		std::memcpy(output.data() + position, delta.data() + index, literal);
+		position += literal;
+		index += literal;
+	}
+	return position == total;
+}
+
+bool snapshot_ring_t::rebuild(arch_t position, std::vector<byte_t>& buffer) const {
+	arch_t first = position;
+	while (!entries[(head + first) % kRingCapacity].keyframe) {
+		if (first == 0) {
+			return false;
+		}
+		--first;
+	}
+	buffer = entries[(head + first) % kRingCapacity].data;
+	std::vector<byte_t> scratch;
+	for (arch_t it = first + 1; it <= position; ++it) {
+		if (!snapshot_ring_t::decode(buffer, entries[(head + it) % kRingCapacity].data, scratch)) {
+			synao_log("Snapshot delta couldn't be decoded!\n");
+			return false;
+		}
+		buffer.swap(scratch);
+	}
+	return true;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <unordered_map>
+#include <entt/core/hashed_string.hpp>
+
+#include "../types.hpp"
+
+namespace snapshot {
+	// Snapshots hold raw component layouts, so they only load in the build that wrote them
+	uint64_t build_id();
+}
+
+// Appends plain values to a byte buffer. Hashed names are written as ids,
+// and the names behind them are collected into a table at the end so a
+// buffer can be read back in a later run.
+struct snapshot_writer_t : public not_copyable_t, public not_moveable_t {
+public:
+	snapshot_writer_t(std::vector<byte_t>& buffer);
+	~snapshot_writer_t() = default;
+public:
+	template<typename T>
+	void value(const T& data);
+	template<typename T>
+	void array(const std::vector<T>& data);
+	void string(const std::string& data);
+	void name(const entt::hashed_string& data);
+	void finish();
+private:
+	void bytes(const void* data, arch_t length);
+private:
+	std::vector<byte_t>& buffer;
+	std::unordered_map<entt::id_type, const byte_t*> names {};
+};
+
+struct snapshot_reader_t : public not_copyable_t, public not_moveable_t {
+public:
+	snapshot_reader_t(const std::vector<byte_t>& buffer);
+	~snapshot_reader_t() = default;
+public:
+	template<typename T>
+	bool value(T& data);
+	template<typename T>
+	bool array(std::vector<T>& data);
+	bool string(std::string& data);
+	bool name(const std::string*& data);
+	bool valid() const;
+private:
+	bool bytes(void* data, arch_t length);
+private:
+	const std::vector<byte_t>& buffer;
+	arch_t index { 0 };
+	arch_t limit { 0 };
+	bool_t failed { false };
+	std::unordered_map<entt::id_type, std::string> names {};
+};
+
+// Recent snapshots, oldest first. Every buffer is kept as the difference
+// from the one before it, with a full keyframe at a fixed interval so that
+// restoring never has to replay more than a few deltas.
+struct snapshot_ring_t : public not_copyable_t {
+public:
+	snapshot_ring_t() = default;
+	snapshot_ring_t(snapshot_ring_t&&) noexcept = default;
+	snapshot_ring_t& operator=(snapshot_ring_t&&) noexcept = default;
+	~snapshot_ring_t() = default;
+public:
+	void reset();
+	void push(const std::vector<byte_t>& buffer);
+	bool get(arch_t age, std::vector<byte_t>& buffer) const;
+	void drop(arch_t count);
+	arch_t size() const;
+	arch_t bytes() const;
+public:
+	static void encode(const std::vector<byte_t>& previous, const std::vector<byte_t>& current, std::vector<byte_t>& output);
+	static bool decode(const std::vector<byte_t>& previous, const std::vector<byte_t>& delta, std::vector<byte_t>& output);
+private:
+	struct entry_t {
+	public:
+		bool_t keyframe { false };
+		std::vector<byte_t> data {};
+	};
+	bool rebuild(arch_t position, std::vector<byte_t>& buffer) const;
+private:
+	std::vector<entry_t> entries {};
+	arch_t head { 0 };
+	arch_t length { 0 };
+	arch_t since { 0 };
+	std::vector<byte_t> latest {};
+};
+
+template<typename T>
+inline void snapshot_writer_t::value(const T& data) {
+	static_assert(std::is_trivially_copyable<T>::value);
+	this->bytes(&data, sizeof(T));
+}
+
+template<typename T>
+inline void snapshot_writer_t::array(const std::vector<T>& data) {
+	static_assert(std::is_trivially_copyable<T>::value);
+	this->value<uint64_t>(data.size());
+	this->bytes(data.data(), data.size() * sizeof(T));
+}
+
+template<typename T>
+inline bool snapshot_reader_t::value(T& data) {
+	static_assert(std::is_trivially_copyable<T>::value);
+	return this->bytes(&data, sizeof(T));
+}
+
+template<typename T>
+inline bool snapshot_reader_t::array(std::vector<T>& data) {
+	static_assert(std::is_trivially_copyable<T>::value);
+	uint64_t count = 0;
+	if (!this->value(count) or count * sizeof(T) > limit - index) {
+		failed = true;
+		return false;
+	}
+	data.resize(static_cast<arch_t>(count));
+	return this->bytes(data.data(), data.size() * sizeof(T));
+}
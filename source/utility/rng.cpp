@@ -1,38 +1,134 @@
 #include "./rng.hpp"
 
-#include <random>
+#include <array>
 #include <chrono>
+#include <sstream>
 
-namespace rng {
-	static sint64_t& current() {
-		static sint64_t s = std::chrono::high_resolution_clock::now()
-			.time_since_epoch()
-			.count();
-		return s;
+// Every thread gets its own streams, so runtimes simulated side by side
+// neither share nor race on the generators
+namespace {
+	using generator_t = std::array<uint32_t, 4>;
+
+	struct rng_state_t {
+	public:
+		sint64_t seed { 0 };
+		std::array<generator_t, rng_stream_t::Total> streams {};
+	};
+
+	uint64_t splitmix(uint64_t& value) {
+		uint64_t result = (value += 0x9E3779B97F4A7C15ULL);
+		result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+		return result ^ (result >> 31);
+	}
+
+	uint32_t rotate(uint32_t value, sint_t count) {
+		return (value << count) | (value >> (32 - count));
+	}
+
+	// xoshiro128**
+	uint32_t advance(generator_t& s) {
+		const uint32_t result = rotate(s[1] * 5, 7) * 9;
+		const uint32_t shifted = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= shifted;
+		s[3] = rotate(s[3], 11);
+		return result;
+	}
+
+	void reseed(rng_state_t& state, sint64_t value) {
+		state.seed = value;
+		for (arch_t it = 0; it < rng_stream_t::Total; ++it) {
+			// Streams are seeded apart from each other, so adding one never moves the rest
+			uint64_t mix = static_cast<uint64_t>(value) ^ (0xD1B54A32D192ED03ULL * (it + 1));
+			auto& s = state.streams[it];
+			const uint64_t lower = splitmix(mix);
+			const uint64_t upper = splitmix(mix);
+			s[0] = static_cast<uint32_t>(lower);
+			s[1] = static_cast<uint32_t>(lower >> 32);
+			s[2] = static_cast<uint32_t>(upper);
+			s[3] = static_cast<uint32_t>(upper >> 32);
+		}
+	}
+
+	rng_state_t& current() {
+		thread_local rng_state_t state = [] {
+			rng_state_t result {};
+			reseed(result, std::chrono::high_resolution_clock::now()
+				.time_since_epoch()
+				.count()
+			);
+			return result;
+		}();
+		return state;
 	}
-	static std::mt19937& mersenne() {
-		auto& s = rng::current();
-		static std::mt19937 generator(static_cast<uint_t>(s));
-		return generator;
+
+	real_t unit(uint32_t value) {
+		// Top 24 bits fill a float's mantissa exactly, giving [0, 1)
+		return static_cast<real_t>(value >> 8) * (1.0f / 16777216.0f);
 	}
+}
+
+namespace rng {
 	sint64_t seed() {
-		auto& s = rng::current();
-		return s;
+		return current().seed;
 	}
 	void seed(sint64_t value) {
-		auto& s = rng::current();
-		s = value;
-		auto& m = rng::mersenne();
-		m.seed(static_cast<uint_t>(s));
+		reseed(current(), value);
+	}
+	std::string state() {
+		auto& state = current();
+		std::ostringstream stream;
+		stream << state.seed;
+		for (auto&& s : state.streams) {
+			stream << ' ' << s[0] << ' ' << s[1] << ' ' << s[2] << ' ' << s[3];
+		}
+		return stream.str();
+	}
+	bool state(const std::string& value) {
+		std::istringstream stream { value };
+		rng_state_t result {};
+		stream >> result.seed;
+		for (auto&& s : result.streams) {
+			stream >> s[0] >> s[1] >> s[2] >> s[3];
+		}
+		if (stream.fail()) {
+			return false;
+		}
+		current() = result;
+		return true;
 	}
 	sint_t next(sint_t low, sint_t high) {
-		auto& m = rng::mersenne();
-		std::uniform_int_distribution<sint_t> distribution(low, high);
-		return distribution(m);
+		return rng::next(rng_stream_t::Script, low, high);
 	}
 	real_t next(real_t low, real_t high) {
-		auto& m = rng::mersenne();
-		std::uniform_real_distribution<real_t> distribution(low, high);
-		return distribution(m);
+		return rng::next(rng_stream_t::Script, low, high);
+	}
+	sint_t next(rng_stream_t stream, sint_t low, sint_t high) {
+		auto& s = current().streams[stream];
+		if (high <= low) {
+			return low;
+		}
+		// Inclusive range, scaled by multiplication instead of a biased modulo
+		const uint64_t range = static_cast<uint64_t>(static_cast<sint64_t>(high) - low) + 1;
+		const uint64_t scaled = (static_cast<uint64_t>(advance(s)) * range) >> 32;
+		return static_cast<sint_t>(static_cast<sint64_t>(low) + static_cast<sint64_t>(scaled));
+	}
+	real_t next(rng_stream_t stream, real_t low, real_t high) {
+		auto& s = current().streams[stream];
+		return low + (high - low) * unit(advance(s));
+	}
+	void fill(rng_stream_t stream, real_t low, real_t high, real_t* output, arch_t count) {
+		// Copy the generator locally so the loop stays in registers
+		auto& state = current().streams[stream];
+		generator_t s = state;
+		const real_t range = high - low;
+		for (arch_t it = 0; it < count; ++it) {
+			output[it] = low + range * unit(advance(s));
+		}
+		state = s;
 	}
 }
@@ -1,10 +1,32 @@
 #pragma once
 
+#include <string>
+
 #include "../types.hpp"
 
+namespace __enum_rng_stream {
+	enum type : arch_t {
+		Script,
+		Combat,
+		Particles,
+		Camera,
+		Cosmetic,
+		Total
+	};
+}
+
+using rng_stream_t = __enum_rng_stream::type;
+
+// Every system draws from its own stream, all derived from one seed, so
+// effects that only exist on screen can't shift what gameplay rolls next.
 namespace rng {
 	sint64_t seed();
 	void seed(sint64_t value);
+	std::string state();
+	bool state(const std::string& value);
 	sint_t next(sint_t low, sint_t high);
 	real_t next(real_t low, real_t high);
+	sint_t next(rng_stream_t stream, sint_t low, sint_t high);
+	real_t next(rng_stream_t stream, real_t low, real_t high);
+	void fill(rng_stream_t stream, real_t low, real_t high, real_t* output, arch_t count);
 }
@@ -2,6 +2,9 @@
 
 #include <functional>
 #include <future>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <thread>
 #include <vector>
@@ -16,19 +19,18 @@ public:
 	thread_pool_t(thread_pool_t&&) noexcept = delete;
 	thread_pool_t& operator=(thread_pool_t&&) noexcept = delete;
 	~thread_pool_t() {
-		shutdown = true;
-		if (!threads.empty()) {
-			{
-				std::unique_lock<std::mutex> notify_lock { conditional_mutex };
-				conditional_lock.notify_all();
-			}
-			for (auto&& thread : threads) {
-				if (thread.joinable()) {
-					thread.join();
-				}
+		{
+			// Set under the lock, so no worker can check the predicate and then miss the wakeup
+			std::unique_lock<std::mutex> shutdown_lock { queue_mutex };
+			shutdown = true;
+		}
+		conditional_lock.notify_all();
+		for (auto&& thread : threads) {
+			if (thread.joinable()) {
+				thread.join();
 			}
-			threads.clear();
 		}
+		threads.clear();
 	}
 public:
 	bool init(arch_t count) {
@@ -52,9 +54,34 @@ public:
 			std::unique_lock<std::mutex> push_lock { queue_mutex };
 			queue.push(wrapper);
 		}
+		// Workers wait on a predicate under queue_mutex, so notifying after unlocking can't be lost
 		conditional_lock.notify_one();
 		return task_pointer->get_future();
 	}
+	// Runs one queued task on the calling thread, returning false if there was none
+	bool help() {
+		std::function<void()> process {};
+		{
+			std::unique_lock<std::mutex> help_lock { queue_mutex };
+			if (queue.empty()) {
+				return false;
+			}
+			process = std::move(queue.front());
+			queue.pop();
+		}
+		std::invoke(process);
+		return true;
+	}
+	// Waits on a future, but works through the queue instead of sleeping while it can
+	template<typename T>
+	void wait(std::future<T>& future) {
+		while (future.valid() and future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (!this->help()) {
+				// Nothing left to steal, so the task is already running on a worker
+				future.wait();
+			}
+		}
+	}
 private:
 	struct worker_t : public not_copyable_t {
 	public:
@@ -64,33 +91,20 @@ private:
 		~worker_t() = default;
 	public:
 		void operator()() {
-			std::function<void()> process {};
-			bool dequeued = false;
-			while (!boss->shutdown) {
+			while (true) {
+				std::function<void()> process {};
 				{
-					std::unique_lock<std::mutex> wait_lock { boss->conditional_mutex };
-					bool empty = false;
-					{
-						std::unique_lock<std::mutex> empty_lock { boss->queue_mutex };
-						empty = boss->queue.empty();
+					std::unique_lock<std::mutex> wait_lock { boss->queue_mutex };
+					boss->conditional_lock.wait(wait_lock, [this] {
+						return boss->shutdown or !boss->queue.empty();
+					});
+					if (boss->shutdown) {
+						return;
 					}
-					if (empty) {
-						boss->conditional_lock.wait(wait_lock);
-					}
-					{
-						std::unique_lock<std::mutex> dequeued_lock { boss->queue_mutex };
-						if (!boss->queue.empty()) {
-							process = std::move(boss->queue.front());
-							boss->queue.pop();
-							dequeued = true;
-						} else {
-							dequeued = false;
-						}
-					}
-				}
-				if (dequeued) {
-					std::invoke(process);
+					process = std::move(boss->queue.front());
+					boss->queue.pop();
 				}
+				std::invoke(process);
 			}
 		}
 	private:
@@ -101,6 +115,5 @@ private:
 	std::queue<std::function<void()> > queue {};
 	std::mutex queue_mutex {};
 	std::vector<std::thread> threads {};
-	std::mutex conditional_mutex {};
 	std::condition_variable conditional_lock {};
 };
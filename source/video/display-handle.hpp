@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../resource/program.hpp"
+#include "../utility/enums.hpp"
+
+#include "./gfx.hpp"
+
+struct display_list_t;
+
+// Remembers which list a caller drew into last frame. The renderer only looks
+// the list up again when the parameters change or the lists were cleared.
+struct display_handle_t {
+public:
+	layer_t layer { layer_value::Automatic };
+	blend_mode_t blend_mode { blend_mode_t::None };
+	program_t program { program_t::Total };
+	arch_t epoch { 0 };
+	display_list_t* list { nullptr };
+};
@@ -4,47 +4,38 @@
 #include "../utility/watch.hpp"
 #include "../utility/rect.hpp"
 
+#include <glm/common.hpp>
 #include <glm/trigonometric.hpp>
 #include <glm/gtc/constants.hpp>
 
-bool display_list_t::operator<(const display_list_t& that) {
-	if (layer_value::equal(this->layer, that.layer)) {
-		if (this->blend_mode == that.blend_mode) {
-			return this->pipeline < that.pipeline;
-		}
-		return this->blend_mode < that.blend_mode;
-	}
-	return this->layer < that.layer;
+namespace {
+	constexpr arch_t kMinimumCapacity = 64;
 }
 
-display_list_t& display_list_t::setup(const quad_allocator_t* allocator) {
-	if (!quad_buffer.valid()) {
-		vertex_spec_t specify;
-		if (pipeline) {
-			specify = pipeline->get_specify();
-		}
-		quad_pool.setup(specify);
-		quad_buffer.setup(allocator, buffer_usage_t::Dynamic, specify);
+display_list_t::~display_list_t() {
+	if (arena) {
+		arena->release(base, capacity);
 	}
-	return *this;
 }
 
 display_list_t& display_list_t::begin(arch_t count) {
-	if ((current + count) > quad_pool.size()) {
-		quad_pool.resize(current + count);
+	if ((current + count) > capacity) {
+		const arch_t length = glm::max(current + count, glm::max(capacity * 2, kMinimumCapacity));
+		base = arena->reallocate(base, capacity, length);
+		capacity = length;
 	}
 	account = count;
 	return *this;
 }
 
 display_list_t& display_list_t::vtx_pool_write(const vertex_pool_t& that_pool) {
-	quad_pool.copy(current, account, that_pool);
+	arena->get_pool().copy(base + current, account, that_pool);
 	return *this;
 }
 
 display_list_t& display_list_t::vtx_blank_write(const rect_t& raster_rect, const glm::vec4& vtx_color) {
 	const sint_t matrix = layer == layer_value::Persistent ? 0 : 1;
-	auto vtx = quad_pool.at<vtx_blank_t>(current);
+	auto vtx = this->at<vtx_blank_t>(current);
 	vtx[0].position = glm::zero<glm::vec2>();
 	vtx[0].matrix 	= matrix;
 	vtx[0].color 	= vtx_color;
@@ -62,7 +53,7 @@ display_list_t& display_list_t::vtx_blank_write(const rect_t& raster_rect, const
 
 display_list_t& display_list_t::vtx_major_write(const rect_t& texture_rect, const glm::vec2& raster_dimensions, mirroring_t mirroring, real_t alpha_color, sint_t texture_name) {
 	const sint_t matrix = layer == layer_value::Persistent ? 0 : 1;
-	auto vtx = quad_pool.at<vtx_major_t>(current);
+	auto vtx = this->at<vtx_major_t>(current);
 	vtx[0].position = glm::zero<glm::vec2>();
 	vtx[0].matrix 	= matrix;
 	vtx[0].uvcoords = texture_rect.left_top();
@@ -102,8 +93,34 @@ display_list_t& display_list_t::vtx_major_write(const rect_t& texture_rect, cons
 	return *this;
 }
 
+display_list_t& display_list_t::vtx_batch_write(arch_t index, const rect_t& texture_rect, const glm::vec2& raster_position, const glm::vec2& raster_dimensions, real_t alpha_color, sint_t texture_name) {
+	const sint_t matrix = layer == layer_value::Persistent ? 0 : 1;
+	auto vtx = this->at<vtx_major_t>(current + index * display_list_t::SingleQuad);
+	vtx[0].position = raster_position;
+	vtx[0].matrix 	= matrix;
+	vtx[0].uvcoords = texture_rect.left_top();
+	vtx[0].alpha	= alpha_color;
+	vtx[0].texID 	= texture_name;
+	vtx[1].position = { raster_position.x, raster_position.y + raster_dimensions.y };
+	vtx[1].matrix 	= matrix;
+	vtx[1].uvcoords = texture_rect.left_bottom();
+	vtx[1].alpha	= alpha_color;
+	vtx[1].texID 	= texture_name;
+	vtx[2].position = { raster_position.x + raster_dimensions.x, raster_position.y };
+	vtx[2].matrix 	= matrix;
+	vtx[2].uvcoords = texture_rect.right_top();
+	vtx[2].alpha	= alpha_color;
+	vtx[2].texID 	= texture_name;
+	vtx[3].position = raster_position + raster_dimensions;
+	vtx[3].matrix 	= matrix;
+	vtx[3].uvcoords = texture_rect.right_bottom();
+	vtx[3].alpha	= alpha_color;
+	vtx[3].texID 	= texture_name;
+	return *this;
+}
+
 display_list_t& display_list_t::vtx_fonts_write(const rect_t& texture_rect, const glm::vec2& raster_dimensions, const glm::vec4& full_color, sint_t atlas_name, sint_t atlas_table) {
-	auto vtx = quad_pool.at<vtx_fonts_t>(current);
+	auto vtx = this->at<vtx_fonts_t>(current);
 	vtx[0].position = glm::zero<glm::vec2>();
 	vtx[0].uvcoords = texture_rect.left_top();
 	vtx[0].color = full_color;
@@ -127,13 +144,27 @@ display_list_t& display_list_t::vtx_fonts_write(const rect_t& texture_rect, cons
 	return *this;
 }
 
+display_list_t& display_list_t::vtx_sprite_write(const rect_t& texture_rect, const glm::vec2& raster_dimensions, mirroring_t mirroring, real_t alpha_color, sint_t texture_name, const glm::vec2& position, const glm::vec2& scale, const glm::vec2& axis, real_t rotation) {
+	auto vtx = this->at<vtx_sprite_t>(current);
+	vtx->bounds = { position, raster_dimensions };
+	vtx->uvcoords = { texture_rect.left_top(), texture_rect.right_bottom() };
+	vtx->transform = { scale, axis };
+	vtx->effects = { rotation, alpha_color };
+	vtx->indices = {
+		layer == layer_value::Persistent ? 0 : 1,
+		texture_name,
+		static_cast<sint_t>(mirroring)
+	};
+	return *this;
+}
+
 display_list_t& display_list_t::vtx_transform_write(const glm::vec2& position, const glm::vec2& scale, const glm::vec2& axis, real_t rotation) {
-	auto vtx = reinterpret_cast<vtx_minor_t*>(quad_pool[current]);
+	auto vtx = this->at<vtx_minor_t>(current);
 	glm::vec2 left_top = position + (scale * vtx->position);
 	real_t cos = rotation != 0.0f ? glm::cos(rotation) : 1.0f;
 	real_t sin = rotation != 0.0f ? glm::sin(rotation) : 0.0f;
 	for (arch_t it = 0; it < account; ++it) {
-		vtx = reinterpret_cast<vtx_minor_t*>(quad_pool[current + it]);
+		vtx = this->at<vtx_minor_t>(current + it);
 		glm::vec2 beg_pos = (position + (scale * vtx->position)) - left_top - axis;
 		glm::vec2 end_pos  = {
 			beg_pos.x * cos - beg_pos.y * sin,
@@ -150,9 +181,9 @@ display_list_t& display_list_t::vtx_transform_write(const glm::vec2& position, c
 }
 
 display_list_t& display_list_t::vtx_transform_write(const glm::vec2& position, const glm::vec2& scale) {
-	vtx_minor_t* vtx = reinterpret_cast<vtx_minor_t*>(quad_pool[current]);
+	vtx_minor_t* vtx = this->at<vtx_minor_t>(current);
 	for (arch_t it = 0; it < account; ++it) {
-		vtx = reinterpret_cast<vtx_minor_t*>(quad_pool[current + it]);
+		vtx = this->at<vtx_minor_t>(current + it);
 		vtx->position *= scale;
 		vtx->position += position;
 	}
@@ -170,7 +201,7 @@ display_list_t& display_list_t::vtx_transform_write(real_t x, real_t y) {
 }
 
 void display_list_t::end() {
-	amend = true;
+	arena->touch(base + current, base + current + account);
 	current += account;
 	account = 0;
 }
@@ -185,32 +216,32 @@ void display_list_t::skip() {
 	account = 0;
 }
 
-void display_list_t::flush(gfx_t& gfx, const sampler_allocator_t* samplers) {
+void display_list_t::flush() {
 	visible = current != 0;
 	if (visible) {
-		if (amend) {
-			amend = false;
-			if (current > quad_buffer.get_length()) {
-				quad_buffer.create(current);
-			}
-			quad_buffer.update(quad_pool[0], current);
-		}
-		gfx.set_blend_mode(blend_mode);
-		gfx.set_pipeline(pipeline);
-		gfx.set_sampler_allocator(samplers);
-		quad_buffer.draw(current);
+		arena->push(base, current);
 	}
 	current = 0;
 }
 
-bool display_list_t::matches(layer_t layer, blend_mode_t blend_mode, const pipeline_t* pipeline) const {
+void display_list_t::draw(gfx_t& gfx, const sampler_allocator_t* samplers) const {
+	gfx.set_blend_mode(blend_mode);
+	gfx.set_pipeline(pipeline);
+	gfx.set_sampler_allocator(samplers);
+	arena->draw();
+}
+
+bool display_list_t::batches(const display_list_t& that) const {
 	return (
-		layer_value::equal(this->layer, layer) and
-		this->blend_mode == blend_mode and
-		this->pipeline == pipeline
+		this->blend_mode == that.blend_mode and
+		this->pipeline == that.pipeline
 	);
 }
 
 bool display_list_t::rendered() const {
 	return visible;
 }
+
+bool display_list_t::empty() const {
+	return current == 0;
+}
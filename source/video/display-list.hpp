@@ -3,8 +3,7 @@
 #include "../utility/enums.hpp"
 
 #include "./gfx.hpp"
-#include "./vertex-pool.hpp"
-#include "./quad-buffer.hpp"
+#include "./vertex-arena.hpp"
 
 struct texture_t;
 struct palette_t;
@@ -13,23 +12,24 @@ struct rect_t;
 
 struct display_list_t : public not_copyable_t {
 public:
-	display_list_t(layer_t layer, blend_mode_t blend_mode, const pipeline_t* pipeline) :
+	display_list_t(layer_t layer, blend_mode_t blend_mode, const pipeline_t* pipeline, vertex_arena_t* arena) :
 		layer(layer),
 		blend_mode(blend_mode),
-		pipeline(pipeline) {}
+		pipeline(pipeline),
+		arena(arena) {}
 	display_list_t() = default;
-	// The default move constructors don't play nice with std::sort
+	// Moving a list hands its arena span over, so each span keeps exactly one owner
 	display_list_t(display_list_t&& that) noexcept : display_list_t() {
 		if (this != &that) {
 			std::swap(layer, that.layer);
 			std::swap(blend_mode, that.blend_mode);
 			std::swap(pipeline, that.pipeline);
+			std::swap(arena, that.arena);
 			std::swap(visible, that.visible);
-			std::swap(amend, that.amend);
 			std::swap(current, that.current);
 			std::swap(account, that.account);
-			std::swap(quad_pool, that.quad_pool);
-			std::swap(quad_buffer, that.quad_buffer);
+			std::swap(base, that.base);
+			std::swap(capacity, that.capacity);
 		}
 	}
 	display_list_t& operator=(display_list_t&& that) noexcept {
@@ -37,24 +37,24 @@ public:
 			std::swap(layer, that.layer);
 			std::swap(blend_mode, that.blend_mode);
 			std::swap(pipeline, that.pipeline);
+			std::swap(arena, that.arena);
 			std::swap(visible, that.visible);
-			std::swap(amend, that.amend);
 			std::swap(current, that.current);
 			std::swap(account, that.account);
-			std::swap(quad_pool, that.quad_pool);
-			std::swap(quad_buffer, that.quad_buffer);
+			std::swap(base, that.base);
+			std::swap(capacity, that.capacity);
 		}
 		return *this;
 	}
-	~display_list_t() = default;
-	bool operator<(const display_list_t& that);
+	~display_list_t();
 public:
-	display_list_t& setup(const quad_allocator_t* allocator);
 	display_list_t& begin(arch_t count);
 	display_list_t& vtx_pool_write(const vertex_pool_t& that_pool);
 	display_list_t& vtx_blank_write(const rect_t& raster_rect, const glm::vec4& vtx_color);
 	display_list_t& vtx_major_write(const rect_t& texture_rect, const glm::vec2& raster_dimensions, mirroring_t mirroring, real_t alpha_color, sint_t texture_name);
+	display_list_t& vtx_batch_write(arch_t index, const rect_t& texture_rect, const glm::vec2& raster_position, const glm::vec2& raster_dimensions, real_t alpha_color, sint_t texture_name);
 	display_list_t& vtx_fonts_write(const rect_t& texture_rect, const glm::vec2& raster_dimensions, const glm::vec4& full_color, sint_t atlas_name, sint_t atlas_table);
+	display_list_t& vtx_sprite_write(const rect_t& texture_rect, const glm::vec2& raster_dimensions, mirroring_t mirroring, real_t alpha_color, sint_t texture_name, const glm::vec2& position, const glm::vec2& scale, const glm::vec2& axis, real_t rotation);
 	display_list_t& vtx_transform_write(const glm::vec2& position, const glm::vec2& scale, const glm::vec2& axis, real_t rotation);
 	display_list_t& vtx_transform_write(const glm::vec2& position, const glm::vec2& axis, real_t rotation);
 	display_list_t& vtx_transform_write(const glm::vec2& position, const glm::vec2& scale);
@@ -63,19 +63,29 @@ public:
 	void end();
 	void skip(arch_t count);
 	void skip();
-	void flush(gfx_t& gfx, const sampler_allocator_t* samplers);
-	bool matches(layer_t layer, blend_mode_t blend_mode, const pipeline_t* pipeline) const;
+	void flush();
+	void draw(gfx_t& gfx, const sampler_allocator_t* samplers) const;
+	bool batches(const display_list_t& that) const;
 	bool rendered() const;
+	bool empty() const;
 public:
 	static constexpr arch_t SingleQuad = 4;
+	static constexpr arch_t SingleSprite = 1;
+private:
+	template<typename V> V* at(arch_t index);
 private:
 	layer_t layer { layer_value::Automatic };
 	blend_mode_t blend_mode { blend_mode_t::None };
 	const pipeline_t* pipeline { nullptr };
+	vertex_arena_t* arena { nullptr };
 	bool_t visible { false };
-	bool_t amend { false };
 	arch_t current { 0 };
 	arch_t account { 0 };
-	vertex_pool_t quad_pool {};
-	quad_buffer_t quad_buffer {};
+	arch_t base { 0 };
+	arch_t capacity { 0 };
 };
+
+template<typename V>
+inline V* display_list_t::at(arch_t index) {
+	return arena->get_pool().at<V>(base + index);
+}
@@ -2,9 +2,18 @@
 #include "./const-buffer.hpp"
 #include "./gl-check.hpp"
 
+#include "../utility/logger.hpp"
+
 #include <limits>
+#include <cstring>
+#include <algorithm>
 #include <glm/common.hpp>
 
+namespace {
+	constexpr uint_t kPersistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	constexpr uint64_t kFenceTimeout = 1000000;
+}
+
 bool quad_allocator_t::create(primitive_t primitive, arch_t length) {
 	if (handle != 0) {
 		return false;
@@ -109,36 +118,50 @@ void quad_buffer_t::setup(const quad_allocator_t* allocator, buffer_usage_t usag
 		if (!arrays) {
 			glCheck(glGenVertexArrays(1, &arrays));
 		}
-		glCheck(glBindVertexArray(arrays));
-
 		if (!buffer) {
 			glCheck(glGenBuffers(1, &buffer));
 		}
-		glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
-		allocator->bind(true);
-
-		if (specify.detail) {
-			specify.detail();
-		}
-		glCheck(glBindVertexArray(0));
-		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-		allocator->bind(false);
+		this->attach();
 	}
 }
 
 void quad_buffer_t::create(arch_t length) {
 	if (allocator and allocator->valid() and arrays != 0) {
 		this->length = length;
+		for (auto&& blocks : pending) {
+			blocks.assign((length + quad_buffer_t::Block - 1) / quad_buffer_t::Block, false);
+		}
+		if (usage == buffer_usage_t::Stream and quad_buffer_t::has_persistent_option()) {
+			// Immutable storage can't be resized, so growing means a new buffer
+			this->release();
+			glCheck(glGenBuffers(1, &buffer));
+			this->attach();
+			const arch_t size = specify.length * length * quad_buffer_t::Regions;
+			glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+			glCheck(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, kPersistentFlags));
+			memory = static_cast<byte_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, kPersistentFlags));
+			glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+			region = 0;
+			if (!memory) {
+				synao_log("Warning! Couldn't map streaming vertex buffer! Falling back to orphaning.\n");
+				this->release();
+				glCheck(glGenBuffers(1, &buffer));
+				this->attach();
+				usage = buffer_usage_t::Dynamic;
+				this->create(length);
+			}
+		} else {
+			uint_t gl_enum = gfx_t::get_buffer_usage_gl_enum(usage);
 
-		uint_t gl_enum = gfx_t::get_buffer_usage_gl_enum(usage);
-
-		glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
-		glCheck(glBufferData(GL_ARRAY_BUFFER, specify.length * length, nullptr, gl_enum));
-		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+			glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+			glCheck(glBufferData(GL_ARRAY_BUFFER, specify.length * length, nullptr, gl_enum));
+			glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		}
 	}
 }
 
 void quad_buffer_t::destroy() {
+	this->release();
 	allocator = nullptr;
 	usage = buffer_usage_t::Static;
 	specify = vertex_spec_t {};
@@ -147,11 +170,6 @@ void quad_buffer_t::destroy() {
 		glCheck(glDeleteVertexArrays(1, &arrays));
 		arrays = 0;
 	}
-	if (buffer != 0) {
-		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-		glCheck(glDeleteBuffers(1, &buffer));
-		buffer = 0;
-	}
 	length = 0;
 }
 
@@ -181,21 +199,139 @@ bool quad_buffer_t::update(const vertex_t* vertices) {
 	return this->update(vertices, length, 0);
 }
 
-void quad_buffer_t::draw(arch_t count) const {
-	if (allocator and allocator->valid() and arrays != 0) {
-		count = quad_allocator_t::convert(count);
+template<typename Function>
+void quad_buffer_t::runs(arch_t index, arch_t count, Function&& function) const {
+	// Adjacent dirty blocks are merged into one copy
+	const auto& blocks = pending[index];
+	const arch_t total = glm::min(static_cast<arch_t>(blocks.size()), (count + quad_buffer_t::Block - 1) / quad_buffer_t::Block);
+	arch_t it = 0;
+	while (it < total) {
+		if (!blocks[it]) {
+			++it;
+			continue;
+		}
+		const arch_t first = it;
+		while (it < total and blocks[it]) {
+			++it;
+		}
+		function(first * quad_buffer_t::Block, glm::min(it * quad_buffer_t::Block, count));
+	}
+}
+
+void quad_buffer_t::mark(arch_t first, arch_t last) {
+	last = glm::min(last, length);
+	if (first >= last) {
+		return;
+	}
+	// Every region has to catch up on what changed while it was in use
+	const arch_t regions = memory ? quad_buffer_t::Regions : 1;
+	const arch_t from = first / quad_buffer_t::Block;
+	const arch_t to = (last + quad_buffer_t::Block - 1) / quad_buffer_t::Block;
+	for (arch_t index = 0; index < regions; ++index) {
+		auto& blocks = pending[index];
+		for (arch_t it = from; it < to; ++it) {
+			blocks[it] = true;
+		}
+	}
+}
+
+bool quad_buffer_t::stream(const vertex_t* vertices, arch_t count) {
+	if (!allocator) {
+		return false;
+	} else if (!allocator->valid() or !arrays) {
+		return false;
+	} else if (!vertices) {
+		return false;
+	}
+	count = glm::min(count, length);
+	const byte_t* source = reinterpret_cast<const byte_t*>(vertices);
+	if (!memory) {
+		auto& blocks = pending[0];
+		const arch_t total = (count + quad_buffer_t::Block - 1) / quad_buffer_t::Block;
+		const bool everything = std::find(blocks.begin(), blocks.begin() + total, false) == blocks.begin() + total;
+		glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+		if (everything and total > 0) {
+			// Orphan the old storage so the driver never waits on draws still reading it
+			uint_t gl_enum = gfx_t::get_buffer_usage_gl_enum(usage);
+			glCheck(glBufferData(GL_ARRAY_BUFFER, specify.length * length, nullptr, gl_enum));
+			glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, specify.length * count, source));
+		} else {
+			this->runs(0, count, [this, source](arch_t first, arch_t last) {
+				glCheck(glBufferSubData(GL_ARRAY_BUFFER, specify.length * first, specify.length * (last - first), source + specify.length * first));
+			});
+		}
+		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		std::fill(blocks.begin(), blocks.end(), false);
+		return true;
+	}
+	region = (region + 1) % quad_buffer_t::Regions;
+	this->wait(region);
+	byte_t* destination = memory + specify.length * region * length;
+	this->runs(region, count, [this, source, destination](arch_t first, arch_t last) {
+		std::memcpy(
+			destination + specify.length * first,
+			source + specify.length * first,
+			specify.length * (last - first)
+		);
+	});
+	std::fill(pending[region].begin(), pending[region].end(), false);
+	return true;
+}
+
+void quad_buffer_t::draw(arch_t count) {
+	const arch_t first = 0;
+	this->draw(&first, &count, 1);
+}
+
+void quad_buffer_t::draw(const arch_t* firsts, const arch_t* counts, arch_t total) {
+	if (allocator and allocator->valid() and arrays != 0 and total > 0) {
+		const uint_t primitive = gfx_t::get_primitive_gl_enum(allocator->get_primitive());
+		const arch_t offset = memory ? region * length : 0;
 		glCheck(glBindVertexArray(arrays));
-		glCheck(glDrawElements(
-			gfx_t::get_primitive_gl_enum(allocator->get_primitive()),
-			static_cast<uint_t>(count),
-			GL_UNSIGNED_SHORT,
-			nullptr
-		));
+		if (specify.instanced) {
+			// Each record is one quad; the vertex shader builds the corners from gl_VertexID
+			for (arch_t it = 0; it < total; ++it) {
+				glCheck(glDrawArraysInstancedBaseInstance(
+					GL_TRIANGLE_STRIP, 0, 4,
+					static_cast<sint_t>(counts[it]),
+					static_cast<uint_t>(offset + firsts[it])
+				));
+			}
+		} else if (total == 1 and offset + firsts[0] == 0) {
+			glCheck(glDrawElements(
+				primitive,
+				static_cast<sint_t>(quad_allocator_t::convert(counts[0])),
+				GL_UNSIGNED_SHORT,
+				nullptr
+			));
+		} else {
+			draw_counts.resize(total);
+			draw_offsets.resize(total, nullptr);
+			draw_bases.resize(total);
+			for (arch_t it = 0; it < total; ++it) {
+				draw_counts[it] = static_cast<sint_t>(quad_allocator_t::convert(counts[it]));
+				draw_bases[it] = static_cast<sint_t>(offset + firsts[it]);
+			}
+			glCheck(glMultiDrawElementsBaseVertex(
+				primitive,
+				draw_counts.data(),
+				GL_UNSIGNED_SHORT,
+				draw_offsets.data(),
+				static_cast<sint_t>(total),
+				draw_bases.data()
+			));
+		}
+		if (memory) {
+			if (fences[region]) {
+				glCheck(glDeleteSync(static_cast<GLsync>(fences[region])));
+			}
+			fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
 		glCheck(glBindVertexArray(0));
 	}
 }
 
-void quad_buffer_t::draw() const {
+void quad_buffer_t::draw() {
 	this->draw(length);
 }
 
@@ -210,3 +346,54 @@ arch_t quad_buffer_t::get_length() const {
 bool quad_buffer_t::valid() const {
 	return allocator and arrays != 0;
 }
+
+bool quad_buffer_t::persistent() const {
+	return memory != nullptr;
+}
+
+bool quad_buffer_t::has_persistent_option() {
+	return const_buffer_t::has_immutable_option();
+}
+
+bool quad_buffer_t::has_instancing() {
+	return opengl_version[0] == 4 and opengl_version[1] >= 2;
+}
+
+void quad_buffer_t::attach() {
+	glCheck(glBindVertexArray(arrays));
+	glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+	allocator->bind(true);
+
+	if (specify.detail) {
+		specify.detail();
+	}
+	glCheck(glBindVertexArray(0));
+	glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	allocator->bind(false);
+}
+
+void quad_buffer_t::wait(arch_t index) {
+	if (fences[index]) {
+		GLsync sync = static_cast<GLsync>(fences[index]);
+		GLenum result = glClientWaitSync(sync, 0, 0);
+		while (result == GL_TIMEOUT_EXPIRED) {
+			result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeout);
+		}
+		glCheck(glDeleteSync(sync));
+		fences[index] = nullptr;
+	}
+}
+
+void quad_buffer_t::release() {
+	for (arch_t it = 0; it < quad_buffer_t::Regions; ++it) {
+		this->wait(it);
+	}
+	if (buffer != 0) {
+		glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		// Deleting the buffer also unmaps it
+		glCheck(glDeleteBuffers(1, &buffer));
+		buffer = 0;
+	}
+	memory = nullptr;
+	region = 0;
+}
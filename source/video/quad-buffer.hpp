@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "./gfx.hpp"
@@ -46,11 +47,26 @@ public:
 	bool update(const vertex_t* vertices, arch_t count, arch_t offset);
 	bool update(const vertex_t* vertices, arch_t count);
 	bool update(const vertex_t* vertices);
-	void draw(arch_t count) const;
-	void draw() const;
+	void mark(arch_t first, arch_t last);
+	bool stream(const vertex_t* vertices, arch_t count);
+	void draw(arch_t count);
+	void draw(const arch_t* firsts, const arch_t* counts, arch_t total);
+	void draw();
 	buffer_usage_t get_usage() const;
 	arch_t get_length() const;
 	bool valid() const;
+	bool persistent() const;
+public:
+	static constexpr arch_t Regions = 3;
+	static constexpr arch_t Block = 64;
+	static bool has_persistent_option();
+	static bool has_instancing();
+private:
+	void attach();
+	void wait(arch_t index);
+	void release();
+	template<typename Function>
+	void runs(arch_t index, arch_t count, Function&& function) const;
 private:
 	friend struct gfx_t;
 	const quad_allocator_t* allocator { nullptr };
@@ -59,4 +75,13 @@ private:
 	uint_t arrays { 0 };
 	uint_t buffer { 0 };
 	arch_t length { 0 };
+	// Streaming buffers are mapped once and split into regions that the
+	// CPU and GPU take turns on, so writing never waits on a draw in flight
+	byte_t* memory { nullptr };
+	arch_t region { 0 };
+	std::array<void_t, Regions> fences {};
+	std::array<std::vector<bool>, Regions> pending {};
+	std::vector<sint_t> draw_counts {};
+	std::vector<const void*> draw_offsets {};
+	std::vector<sint_t> draw_bases {};
 };
@@ -3,12 +3,15 @@
 
 #include "../utility/logger.hpp"
 
+#include <glm/gtc/constants.hpp>
+
 namespace {
 	constexpr sint_t kWorkingUnit = GL_TEXTURE4;
 	constexpr sint_t kMipMapTexs  = 4;
 	constexpr sint_t kTotalTexs   = 80;
 	constexpr sint_t kDimensions  = 256;
 	constexpr sint_t kTotalAtlas  = 5;
+	constexpr sint_t kIndicesUnit = GL_TEXTURE2;
 }
 
 sint_t sampler_t::get_working_unit() {
@@ -37,6 +40,91 @@ void sampler_data_t::destroy() {
 	}
 }
 
+bool sampler_indices_t::create(const glm::ivec2& dimensions, sint_t count) {
+	this->destroy();
+	sint_t maximum_size = 0;
+	sint_t maximum_layers = 0;
+	glCheck(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maximum_size));
+	glCheck(glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maximum_layers));
+	if (dimensions.x > maximum_size or dimensions.y > maximum_size or count > maximum_layers) {
+		synao_log("Warning! Tile indices of {}x{}x{} exceed this device's texture limits!\n", dimensions.x, dimensions.y, count);
+		return false;
+	}
+
+	// Save previous unit and set to indices unit
+	sint_t previous = 0;
+	glCheck(glGetIntegerv(GL_ACTIVE_TEXTURE, &previous));
+	glCheck(glActiveTexture(kIndicesUnit));
+
+	uint_t handle = 0;
+	glCheck(glGenTextures(1, &handle));
+	glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, handle));
+
+	if (sampler_t::has_immutable_option()) {
+		glCheck(glTexStorage3D(
+			GL_TEXTURE_2D_ARRAY, 1, GL_R16UI,
+			dimensions.x, dimensions.y, count
+		));
+	} else {
+		glCheck(glTexImage3D(
+			GL_TEXTURE_2D_ARRAY, 0, GL_R16UI,
+			dimensions.x, dimensions.y, count,
+			0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr
+		));
+	}
+	// Integer textures can't be filtered
+	glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+	glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	glCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+
+	// Stays bound to the indices unit, nothing else uses it
+	glCheck(glActiveTexture(previous));
+
+	indices.id = handle;
+	indices.type = GL_TEXTURE_2D_ARRAY;
+	indices.count = count;
+	this->dimensions = dimensions;
+	return true;
+}
+
+void sampler_indices_t::update(const uint16_t* pointer, sint_t index) {
+	if (indices.id != 0 and pointer and index < indices.count) {
+		sint_t previous = 0;
+		glCheck(glGetIntegerv(GL_ACTIVE_TEXTURE, &previous));
+		glCheck(glActiveTexture(kIndicesUnit));
+		glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, indices.id));
+		glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 2));
+		glCheck(glTexSubImage3D(
+			GL_TEXTURE_2D_ARRAY, 0,
+			0, 0, index,
+			dimensions.x, dimensions.y, 1,
+			GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+			pointer
+		));
+		glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+		glCheck(glActiveTexture(previous));
+	}
+}
+
+void sampler_indices_t::destroy() {
+	indices.destroy();
+	dimensions = glm::zero<glm::ivec2>();
+}
+
+bool sampler_indices_t::valid() const {
+	return indices.id != 0;
+}
+
+glm::ivec2 sampler_indices_t::get_dimensions() const {
+	return dimensions;
+}
+
+sint_t sampler_indices_t::get_binding_unit() {
+	return kIndicesUnit - GL_TEXTURE0;
+}
+
 sampler_data_t sampler_allocator_t::kNullHandle {};
 
 bool sampler_allocator_t::create(pixel_format_t format) {
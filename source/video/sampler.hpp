@@ -1,5 +1,7 @@
 #pragma once
 
+#include <glm/vec2.hpp>
+
 #include "./gfx.hpp"
 
 struct sampler_t {
@@ -30,6 +32,24 @@ public:
 	sint_t count { 0 };
 };
 
+struct sampler_indices_t : public not_copyable_t {
+public:
+	sampler_indices_t() = default;
+	sampler_indices_t(sampler_indices_t&&) noexcept = default;
+	sampler_indices_t& operator=(sampler_indices_t&&) noexcept = default;
+	~sampler_indices_t() = default;
+public:
+	bool create(const glm::ivec2& dimensions, sint_t count);
+	void update(const uint16_t* pointer, sint_t index);
+	void destroy();
+	bool valid() const;
+	glm::ivec2 get_dimensions() const;
+	static sint_t get_binding_unit();
+private:
+	sampler_data_t indices {};
+	glm::ivec2 dimensions {};
+};
+
 struct sampler_allocator_t : public not_copyable_t {
 public:
 	sampler_allocator_t() = default;
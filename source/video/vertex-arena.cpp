@@ -0,0 +1,120 @@
+#include "./vertex-arena.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <glm/common.hpp>
+
+namespace {
+	constexpr arch_t kMinimumLength = 4096;
+}
+
+void vertex_arena_t::setup(const quad_allocator_t* allocator, vertex_spec_t specify) {
+	pool.setup(specify);
+	buffer.setup(allocator, buffer_usage_t::Stream, specify);
+	top = 0;
+	amend = false;
+	spans.clear();
+	firsts.clear();
+	counts.clear();
+}
+
+arch_t vertex_arena_t::allocate(arch_t count) {
+	// First fit from released spans, otherwise grow at the top
+	for (auto iter = spans.begin(); iter != spans.end(); ++iter) {
+		if (iter->count >= count) {
+			const arch_t base = iter->base;
+			iter->base += count;
+			iter->count -= count;
+			if (iter->count == 0) {
+				spans.erase(iter);
+			}
+			return base;
+		}
+	}
+	const arch_t base = top;
+	top += count;
+	if (top > pool.size()) {
+		pool.resize(top);
+	}
+	return base;
+}
+
+arch_t vertex_arena_t::reallocate(arch_t base, arch_t count, arch_t length) {
+	const arch_t result = this->allocate(length);
+	if (count > 0) {
+		// Lists skip over quads they didn't change, so old contents have to move with them
+		const arch_t moved = glm::min(count, length);
+		std::memmove(pool[result], pool[base], pool.get_specify().length * moved);
+		this->touch(result, result + moved);
+		this->release(base, count);
+	}
+	return result;
+}
+
+void vertex_arena_t::release(arch_t base, arch_t count) {
+	if (count == 0) {
+		return;
+	}
+	auto iter = std::lower_bound(spans.begin(), spans.end(), base, [](const span_t& span, arch_t value) {
+		return span.base < value;
+	});
+	iter = spans.insert(iter, span_t { base, count });
+	// Merge with neighbors so freed space doesn't splinter
+	if (iter + 1 != spans.end() and iter->base + iter->count == (iter + 1)->base) {
+		iter->count += (iter + 1)->count;
+		spans.erase(iter + 1);
+	}
+	if (iter != spans.begin() and (iter - 1)->base + (iter - 1)->count == iter->base) {
+		(iter - 1)->count += iter->count;
+		iter = spans.erase(iter) - 1;
+	}
+	if (iter->base + iter->count == top) {
+		top = iter->base;
+		spans.erase(iter);
+	}
+}
+
+void vertex_arena_t::touch(arch_t first, arch_t last) {
+	amend = true;
+	buffer.mark(first, last);
+}
+
+void vertex_arena_t::flush() {
+	if (top > buffer.get_length()) {
+		// Grow ahead of demand, since streaming storage is remade on every resize
+		buffer.create(glm::max(top + top / 2, kMinimumLength));
+		buffer.mark(0, top);
+		amend = true;
+	}
+	if (amend) {
+		amend = false;
+		buffer.stream(pool[0], top);
+	}
+}
+
+void vertex_arena_t::push(arch_t first, arch_t count) {
+	firsts.push_back(first);
+	counts.push_back(count);
+}
+
+void vertex_arena_t::draw() {
+	buffer.draw(firsts.data(), counts.data(), firsts.size());
+	firsts.clear();
+	counts.clear();
+}
+
+vertex_pool_t& vertex_arena_t::get_pool() {
+	return pool;
+}
+
+const vertex_spec_t& vertex_arena_t::get_specify() const {
+	return pool.get_specify();
+}
+
+arch_t vertex_arena_t::get_length() const {
+	return top;
+}
+
+bool vertex_arena_t::valid() const {
+	return buffer.valid();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include "./vertex-pool.hpp"
+#include "./quad-buffer.hpp"
+
+// One buffer per vertex format, shared by every display list that uses it.
+// Lists own spans of the arena's vertices, and lists drawn back to back
+// with the same state are submitted together in one call.
+struct vertex_arena_t : public not_copyable_t {
+public:
+	vertex_arena_t() = default;
+	vertex_arena_t(vertex_arena_t&&) noexcept = default;
+	vertex_arena_t& operator=(vertex_arena_t&&) noexcept = default;
+	~vertex_arena_t() = default;
+public:
+	void setup(const quad_allocator_t* allocator, vertex_spec_t specify);
+	arch_t allocate(arch_t count);
+	arch_t reallocate(arch_t base, arch_t count, arch_t length);
+	void release(arch_t base, arch_t count);
+	void touch(arch_t first, arch_t last);
+	void flush();
+	void push(arch_t first, arch_t count);
+	void draw();
+	vertex_pool_t& get_pool();
+	const vertex_spec_t& get_specify() const;
+	arch_t get_length() const;
+	bool valid() const;
+private:
+	struct span_t {
+	public:
+		arch_t base { 0 };
+		arch_t count { 0 };
+	};
+	vertex_pool_t pool {};
+	quad_buffer_t buffer {};
+	arch_t top { 0 };
+	bool_t amend { false };
+	std::vector<span_t> spans {};
+	std::vector<arch_t> firsts {};
+	std::vector<arch_t> counts {};
+};
@@ -25,6 +25,8 @@ vertex_spec_t vertex_spec_t::from(const uint_t* list) {
 	static const uint_t kBlank[]  = { GL_FLOAT_VEC2, GL_INT, GL_FLOAT_VEC4, 0 };
 	static const uint_t kMajor[] = { GL_FLOAT_VEC2, GL_INT, GL_FLOAT_VEC2, GL_FLOAT, GL_INT, 0 };
 	static const uint_t kFonts[]  = { GL_FLOAT_VEC2, GL_FLOAT_VEC2, GL_FLOAT_VEC4, GL_INT, GL_INT, 0 };
+	static const uint_t kTiles[]  = { GL_FLOAT_VEC2, GL_INT, GL_FLOAT_VEC2, GL_INT, GL_INT, 0 };
+	static const uint_t kSprite[] = { GL_FLOAT_VEC4, GL_FLOAT_VEC4, GL_FLOAT_VEC4, GL_FLOAT_VEC2, GL_INT_VEC3, 0 };
 	vertex_spec_t result;
 	if (vertex_spec_t::compare(list, kMinor)) {
 		result = vertex_spec_t::from(vtx_minor_t::name());
@@ -34,6 +36,10 @@ vertex_spec_t vertex_spec_t::from(const uint_t* list) {
 		result = vertex_spec_t::from(vtx_major_t::name());
 	} else if (vertex_spec_t::compare(list, kFonts)) {
 		result = vertex_spec_t::from(vtx_fonts_t::name());
+	} else if (vertex_spec_t::compare(list, kTiles)) {
+		result = vertex_spec_t::from(vtx_tiles_t::name());
+	} else if (vertex_spec_t::compare(list, kSprite)) {
+		result = vertex_spec_t::from(vtx_sprite_t::name());
 	}
 	return result;
 }
@@ -140,6 +146,80 @@ vertex_spec_t vertex_spec_t::from(arch_t name) {
 				(const void_t)offsetof(vtx_fonts_t, table)
 			));
 		};
+	} else if (name == vtx_tiles_t::name()) {
+		result.length = sizeof(vtx_tiles_t);
+		result.detail = [] {
+			glCheck(glEnableVertexAttribArray(0));
+			glCheck(glVertexAttribPointer(
+				0, glm::vec2::length(),
+				GL_FLOAT, GL_FALSE, sizeof(vtx_tiles_t),
+				(const void_t)offsetof(vtx_tiles_t, position)
+			));
+			glCheck(glEnableVertexAttribArray(1));
+			glCheck(glVertexAttribIPointer(
+				1, 1,
+				GL_INT, sizeof(vtx_tiles_t),
+				(const void_t)offsetof(vtx_tiles_t, matrix)
+			));
+			glCheck(glEnableVertexAttribArray(2));
+			glCheck(glVertexAttribPointer(
+				2, glm::vec2::length(),
+				GL_FLOAT, GL_FALSE, sizeof(vtx_tiles_t),
+				(const void_t)offsetof(vtx_tiles_t, uvcoords)
+			));
+			glCheck(glEnableVertexAttribArray(3));
+			glCheck(glVertexAttribIPointer(
+				3, 1,
+				GL_INT, sizeof(vtx_tiles_t),
+				(const void_t)offsetof(vtx_tiles_t, texID)
+			));
+			glCheck(glEnableVertexAttribArray(4));
+			glCheck(glVertexAttribIPointer(
+				4, 1,
+				GL_INT, sizeof(vtx_tiles_t),
+				(const void_t)offsetof(vtx_tiles_t, index)
+			));
+		};
+	} else if (name == vtx_sprite_t::name()) {
+		result.length = sizeof(vtx_sprite_t);
+		result.instanced = true;
+		result.detail = [] {
+			glCheck(glEnableVertexAttribArray(0));
+			glCheck(glVertexAttribPointer(
+				0, glm::vec4::length(),
+				GL_FLOAT, GL_FALSE, sizeof(vtx_sprite_t),
+				(const void_t)offsetof(vtx_sprite_t, bounds)
+			));
+			glCheck(glVertexAttribDivisor(0, 1));
+			glCheck(glEnableVertexAttribArray(1));
+			glCheck(glVertexAttribPointer(
+				1, glm::vec4::length(),
+				GL_FLOAT, GL_FALSE, sizeof(vtx_sprite_t),
+				(const void_t)offsetof(vtx_sprite_t, uvcoords)
+			));
+			glCheck(glVertexAttribDivisor(1, 1));
+			glCheck(glEnableVertexAttribArray(2));
+			glCheck(glVertexAttribPointer(
+				2, glm::vec4::length(),
+				GL_FLOAT, GL_FALSE, sizeof(vtx_sprite_t),
+				(const void_t)offsetof(vtx_sprite_t, transform)
+			));
+			glCheck(glVertexAttribDivisor(2, 1));
+			glCheck(glEnableVertexAttribArray(3));
+			glCheck(glVertexAttribPointer(
+				3, glm::vec2::length(),
+				GL_FLOAT, GL_FALSE, sizeof(vtx_sprite_t),
+				(const void_t)offsetof(vtx_sprite_t, effects)
+			));
+			glCheck(glVertexAttribDivisor(3, 1));
+			glCheck(glEnableVertexAttribArray(4));
+			glCheck(glVertexAttribIPointer(
+				4, glm::ivec3::length(),
+				GL_INT, sizeof(vtx_sprite_t),
+				(const void_t)offsetof(vtx_sprite_t, indices)
+			));
+			glCheck(glVertexAttribDivisor(4, 1));
+		};
 	}
 	if (result.length == 0) {
 		synao_log("Warning! vertex_spec_t result has a length of zero!\n");
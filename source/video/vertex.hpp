@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
 #include "../types.hpp"
@@ -81,10 +82,44 @@ public:
 	sint_t table { 0 };
 };
 
+struct vtx_tiles_t : public crtp_vertex_t<vtx_tiles_t> {
+public:
+	vtx_tiles_t() = default;
+	vtx_tiles_t(const vtx_tiles_t&) = default;
+	vtx_tiles_t(vtx_tiles_t&&) noexcept = default;
+	vtx_tiles_t& operator=(const vtx_tiles_t&) = default;
+	vtx_tiles_t& operator=(vtx_tiles_t&&) noexcept = default;
+	~vtx_tiles_t() = default;
+public:
+	glm::vec2 position {};
+	sint_t matrix { 0 };
+	glm::vec2 uvcoords {};
+	sint_t texID { 0 };
+	sint_t index { 0 };
+};
+
+// One record per sprite, expanded into a quad by the vertex shader
+struct vtx_sprite_t : public crtp_vertex_t<vtx_sprite_t> {
+public:
+	vtx_sprite_t() = default;
+	vtx_sprite_t(const vtx_sprite_t&) = default;
+	vtx_sprite_t(vtx_sprite_t&&) noexcept = default;
+	vtx_sprite_t& operator=(const vtx_sprite_t&) = default;
+	vtx_sprite_t& operator=(vtx_sprite_t&&) noexcept = default;
+	~vtx_sprite_t() = default;
+public:
+	glm::vec4 bounds {}; // position, dimensions
+	glm::vec4 uvcoords {}; // left-top, right-bottom
+	glm::vec4 transform { 1.0f, 1.0f, 0.0f, 0.0f }; // scale, pivot
+	glm::vec2 effects { 0.0f, 1.0f }; // rotation, alpha
+	glm::ivec3 indices {}; // matrix, texID, mirroring
+};
+
 struct vertex_spec_t {
 public:
 	void(*detail)(void) { nullptr };
 	arch_t length { 0 };
+	bool_t instanced { false };
 public:
 	vertex_spec_t() = default;
 	vertex_spec_t(const vertex_spec_t&) = default;
@@ -96,13 +131,14 @@ public:
 	static bool compare(const uint_t* lhv, const uint_t* rhv);
 	static vertex_spec_t from(const uint_t* list);
 	static vertex_spec_t from(arch_t vtx);
-	bool operator==(const vertex_spec_t& that) {
+	bool operator==(const vertex_spec_t& that) const {
 		return (
 			this->detail == that.detail and
-			this->length == that.length
+			this->length == that.length and
+			this->instanced == that.instanced
 		);
 	}
-	bool operator!=(const vertex_spec_t& that) {
+	bool operator!=(const vertex_spec_t& that) const {
 		return !(*this == that);
 	}
 };